@@ -10,6 +10,7 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/net/offloaded_netdev.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
 
 LOG_MODULE_REGISTER(modem_simcom_sim800l, CONFIG_MODEM_SIM800L_LOG_LEVEL);
 
@@ -18,38 +19,30 @@ LOG_MODULE_REGISTER(modem_simcom_sim800l, CONFIG_MODEM_SIM800L_LOG_LEVEL);
 
 #include "sim800l.h"
 
-static struct k_thread modem_rx_thread;
-static K_KERNEL_STACK_DEFINE(modem_rx_stack, 2048);
-NET_BUF_POOL_DEFINE(mdm_recv_pool, MDM_RECV_MAX_BUF, MDM_RECV_BUF_SIZE, 0, NULL);
-
-/* Device instance definition */
-struct sim800l_data mdata = {
-	.reset_gpio = GPIO_DT_SPEC_INST_GET_OR(0, mdm_reset_gpios, {}),
-	.powered = false,
-};
-
-static const struct sim800l_config mconfig = {
-	.uart = DEVICE_DT_GET(DT_INST_BUS(0)),
-};
-
 MODEM_CMD_DEFINE(on_cmd_ok)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	modem_cmd_handler_set_error(data, 0);
-	k_sem_give(&mdata.sem_response);
+	k_sem_give(&mdata->sem_response);
 	return 0;
 }
 
 MODEM_CMD_DEFINE(on_cmd_error)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	modem_cmd_handler_set_error(data, -EIO);
-	k_sem_give(&mdata.sem_response);
+	k_sem_give(&mdata->sem_response);
 	return 0;
 }
 
 MODEM_CMD_DEFINE(on_cmd_exterror)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	modem_cmd_handler_set_error(data, -EIO);
-	k_sem_give(&mdata.sem_response);
+	k_sem_give(&mdata->sem_response);
 	return 0;
 }
 
@@ -73,13 +66,35 @@ MODEM_CMD_DEFINE(on_urc_ftpget)
 	int error = atoi(argv[0]);
 
 	LOG_DBG("+FTPGET: 1,%d", error);
+#ifdef CONFIG_MODEM_SIM800L_FTP
+	modem_ftp_urc(data->user_data, error);
+#endif
+	return 0;
+}
+
+#ifdef CONFIG_MODEM_SIM800L_HTTP
+/*
+ * Handles the httpaction urc.
+ *
+ * +HTTPACTION: <method>,<status>,<datalen>
+ */
+MODEM_CMD_DEFINE(on_urc_httpaction)
+{
+	int status = atoi(argv[1]);
+	int len = atoi(argv[2]);
+
+	LOG_DBG("+HTTPACTION: %s,%d,%d", argv[0], status, len);
+	modem_http_action(data->user_data, status, MAX(len, 0));
 	return 0;
 }
+#endif
 
 MODEM_CMD_DIRECT_DEFINE(on_urc_rdy)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	LOG_DBG("RDY received");
-	k_sem_give(&mdata.boot_sem);
+	k_sem_give(&mdata->boot_sem);
 	return 0;
 }
 
@@ -89,72 +104,28 @@ MODEM_CMD_DIRECT_DEFINE(on_urc_pwr_down)
 	return 0;
 }
 
-MODEM_CMD_DEFINE(on_psuttz)
+#ifdef CONFIG_MODEM_SIM800L_TIME
+/*
+ * Network time after registration, enabled by AT+CLTS=1.
+ * *PSUTTZ: <year>,<month>,<day>,<hour>,<minute>,<second>,"<timezone>",<dst>
+ */
+MODEM_CMD_DEFINE(on_urc_psuttz)
 {
-	int year, month, day, hour, minute, second;
-	char timezone[16];
-	int dst;
-
-	return 0;
-	/*
-	 * Parse PSUTTZ message format:
-	 * *PSUTTZ: <year>,<month>,<day>,<hour>,<minute>,<second>,"<timezone>",<dst>
-	 * Example: *PSUTTZ: 25,1,15,10,30,45,"+08",0
-	 *
-	 * Note: The timezone is quoted and needs to be parsed from argv[6]
-	 */
-	if (argc < 7) {
-		LOG_ERR("Invalid PSUTTZ message format, argc=%d (expected at least 7)", argc);
-		return -EINVAL;
-	}
-
-	year = atoi(argv[0]);   /* Year (2 digits, e.g., 25 for 2025) */
-	month = atoi(argv[1]);  /* Month (1-12) */
-	day = atoi(argv[2]);    /* Day (1-31) */
-	hour = atoi(argv[3]);   /* Hour (0-23) */
-	minute = atoi(argv[4]); /* Minute (0-59) */
-	second = atoi(argv[5]); /* Second (0-59) */
-
-	/* Parse timezone - remove quotes if present */
-	size_t tz_len = strlen(argv[6]);
-	if (tz_len > 0 && argv[6][0] == '"') {
-		/* Skip leading quote */
-		size_t copy_len = (tz_len > 2) ? (tz_len - 2) : 0;
-		if (copy_len >= sizeof(timezone)) {
-			copy_len = sizeof(timezone) - 1;
-		}
-		memcpy(timezone, argv[6] + 1, copy_len);
-		timezone[copy_len] = '\0';
-		/* Remove trailing quote if it exists */
-		if (copy_len > 0 && timezone[copy_len - 1] == '"') {
-			timezone[copy_len - 1] = '\0';
-		}
-	} else {
-		strncpy(timezone, argv[6], sizeof(timezone) - 1);
-		timezone[sizeof(timezone) - 1] = '\0';
-	}
-
-	/* DST might be in argv[7] if timezone parsing worked correctly */
-	dst = (argc >= 8) ? atoi(argv[7]) : 0;
-
-	LOG_DBG("Network time: 20%02d-%02d-%02d %02d:%02d:%02d TZ=%s DST=%d", year, month, day,
-		hour, minute, second, timezone, dst);
-
-	/* TODO: Update system time if needed */
-	/* This could be used to synchronize the system clock with network time */
-
+	modem_time_network(data->user_data, argv, argc);
 	return 0;
 }
+#endif
 
 /*
  * Read manufacturer identification.
  */
 MODEM_CMD_DEFINE(on_cmd_cgmi)
 {
-	size_t out_len = net_buf_linearize(mdata.manufacturer, sizeof(mdata.manufacturer) - 1,
+	struct sim800l_data *mdata = data->user_data;
+	size_t out_len = net_buf_linearize(mdata->manufacturer, sizeof(mdata->manufacturer) - 1,
 					   data->rx_buf, 0, len);
-	mdata.manufacturer[out_len] = '\0';
-	LOG_DBG("Manufacturer: %s", mdata.manufacturer);
+	mdata->manufacturer[out_len] = '\0';
+	LOG_DBG("Manufacturer: %s", mdata->manufacturer);
 	return 0;
 }
 
@@ -163,11 +134,12 @@ MODEM_CMD_DEFINE(on_cmd_cgmi)
  */
 MODEM_CMD_DEFINE(on_cmd_cgmm)
 {
+	struct sim800l_data *mdata = data->user_data;
 	size_t out_len =
-		net_buf_linearize(mdata.model, sizeof(mdata.model) - 1, data->rx_buf, 0, len);
+		net_buf_linearize(mdata->model, sizeof(mdata->model) - 1, data->rx_buf, 0, len);
 
-	mdata.model[out_len] = '\0';
-	LOG_DBG("Model: %s", mdata.model);
+	mdata->model[out_len] = '\0';
+	LOG_DBG("Model: %s", mdata->model);
 	return 0;
 }
 
@@ -178,21 +150,22 @@ MODEM_CMD_DEFINE(on_cmd_cgmm)
  */
 MODEM_CMD_DEFINE(on_cmd_cgmr)
 {
+	struct sim800l_data *mdata = data->user_data;
 	size_t out_len;
 	char *p;
 
-	out_len =
-		net_buf_linearize(mdata.revision, sizeof(mdata.revision) - 1, data->rx_buf, 0, len);
-	mdata.revision[out_len] = '\0';
+	out_len = net_buf_linearize(mdata->revision, sizeof(mdata->revision) - 1, data->rx_buf, 0,
+				    len);
+	mdata->revision[out_len] = '\0';
 
 	/* The module prepends a Revision: */
-	p = strchr(mdata.revision, ':');
+	p = strchr(mdata->revision, ':');
 	if (p) {
 		out_len = strlen(p + 1);
-		memmove(mdata.revision, p + 1, out_len + 1);
+		memmove(mdata->revision, p + 1, out_len + 1);
 	}
 
-	LOG_DBG("Revision: %s", mdata.revision);
+	LOG_DBG("Revision: %s", mdata->revision);
 	return 0;
 }
 
@@ -201,11 +174,40 @@ MODEM_CMD_DEFINE(on_cmd_cgmr)
  */
 MODEM_CMD_DEFINE(on_cmd_cgsn)
 {
+	struct sim800l_data *mdata = data->user_data;
 	size_t out_len =
-		net_buf_linearize(mdata.imei, sizeof(mdata.imei) - 1, data->rx_buf, 0, len);
+		net_buf_linearize(mdata->imei, sizeof(mdata->imei) - 1, data->rx_buf, 0, len);
 
-	mdata.imei[out_len] = '\0';
-	LOG_DBG("IMEI: %s", mdata.imei);
+	mdata->imei[out_len] = '\0';
+	LOG_DBG("IMEI: %s", mdata->imei);
+	return 0;
+}
+
+/*
+ * Read the SIM IMSI.
+ */
+MODEM_CMD_DEFINE(on_cmd_cimi)
+{
+	struct sim800l_data *mdata = data->user_data;
+	size_t out_len =
+		net_buf_linearize(mdata->imsi, sizeof(mdata->imsi) - 1, data->rx_buf, 0, len);
+
+	mdata->imsi[out_len] = '\0';
+	LOG_DBG("IMSI: %s", mdata->imsi);
+	return 0;
+}
+
+/*
+ * Read the SIM ICCID.
+ */
+MODEM_CMD_DEFINE(on_cmd_ccid)
+{
+	struct sim800l_data *mdata = data->user_data;
+	size_t out_len =
+		net_buf_linearize(mdata->iccid, sizeof(mdata->iccid) - 1, data->rx_buf, 0, len);
+
+	mdata->iccid[out_len] = '\0';
+	LOG_DBG("ICCID: %s", mdata->iccid);
 	return 0;
 }
 
@@ -215,32 +217,42 @@ MODEM_CMD_DEFINE(on_urc_ciev)
 	return 0;
 }
 
+/*
+ * +CREG: <stat> on a registration change, +CREG: <n>,<stat> in response to
+ * AT+CREG?. Unsolicited commands are matched first, so both end up here.
+ */
 MODEM_CMD_DEFINE(on_urc_creg)
 {
-	int reg_state = atoi(argv[0]);
+	struct sim800l_data *mdata = data->user_data;
+	int reg_state = atoi(argv[argc - 1]);
 
+	mdata->network_registration = reg_state;
 	LOG_DBG("+CREG: %d", reg_state);
 
 	if (reg_state == 1 || reg_state == 5) {
 		/* Registered on home network or roaming */
-		mdata.state = SIM800L_STATE_READY;
-		k_sem_give(&mdata.boot_sem);
+		mdata->state = SIM800L_STATE_READY;
+		k_sem_give(&mdata->boot_sem);
 	} else {
 		/* Not registered */
-		mdata.state = SIM800L_STATE_INIT;
+		mdata->state = SIM800L_STATE_INIT;
 	}
 
+	modem_link_update(mdata);
+
 	return 0;
 }
 
 MODEM_CMD_DEFINE(on_urc_cpin)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	if (strcmp(argv[0], "READY") == 0) {
-		mdata.status_flags |= SIM800L_STATUS_FLAG_CPIN_READY;
+		mdata->status_flags |= SIM800L_STATUS_FLAG_CPIN_READY;
 	} else {
-		mdata.status_flags &= ~SIM800L_STATUS_FLAG_CPIN_READY;
+		mdata->status_flags &= ~SIM800L_STATUS_FLAG_CPIN_READY;
 	}
-	k_sem_give(&mdata.boot_sem);
+	k_sem_give(&mdata->boot_sem);
 
 	LOG_DBG("CPIN: %s", argv[0]);
 	return 0;
@@ -248,57 +260,74 @@ MODEM_CMD_DEFINE(on_urc_cpin)
 
 MODEM_CMD_DEFINE(on_urc_pdp_deact)
 {
-	mdata.status_flags &= ~SIM800L_STATUS_FLAG_PDP_ACTIVE;
+	struct sim800l_data *mdata = data->user_data;
+
+	mdata->status_flags &= ~SIM800L_STATUS_FLAG_PDP_ACTIVE;
+	modem_link_update(mdata);
 	LOG_DBG("PDP context deactivated by network");
 	return 0;
 }
 
-/* URC: +RECEIVE,<n>,<data length>:\r\n<data> */
-MODEM_CMD_DEFINE(on_urc_receive)
+/*
+ * URC: RECV FROM:<ip>:<port>
+ *
+ * Sent ahead of +RECEIVE when AT+CIPSRIP=1 is set. Remembered until the
+ * payload arrives so datagrams carry their real sender.
+ */
+MODEM_CMD_DEFINE(on_urc_recv_from)
 {
-	struct modem_socket *sock;
-	int ret;
-	int sock_id;
-	int data_len;
-	uint8_t chunk[128];
+	struct sim800l_data *mdata = data->user_data;
+	struct sockaddr_in *addr = &mdata->rx_src;
+	char *ip = argv[0];
+	char *port = strrchr(ip, ':');
 
-	sock_id = atoi(argv[0]);
-	data_len = atoi(argv[1]);
-
-	LOG_DBG("+RECEIVE: socket %d, length %d", sock_id, data_len);
+	mdata->rx_src_valid = false;
 
-	/* Find the socket */
-	sock = modem_socket_from_id(&mdata.socket_config, sock_id);
-	if (!sock) {
-		LOG_WRN("Received data for unknown socket %d", sock_id);
+	if (!port) {
+		LOG_WRN("Malformed sender address %s", ip);
 		return 0;
 	}
 
-	struct sim800l_socket_data *sock_data = (struct sim800l_socket_data *)sock->data;
-
-	k_mutex_lock(&sock_data->lock, K_FOREVER);
-
-	if (!sock_data->rx_buf) {
-		sock_data->rx_buf = net_buf_alloc(&mdm_recv_pool, K_NO_WAIT);
-		if (!sock_data->rx_buf) {
-			LOG_ERR("Socket %d RX buffer alloc failed", sock_id);
-			k_mutex_unlock(&sock_data->lock);
-			return 0;
-		}
+	*port++ = '\0';
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(atoi(port));
+	if (net_addr_pton(AF_INET, ip, &addr->sin_addr) < 0) {
+		LOG_WRN("Malformed sender address %s", ip);
+		return 0;
 	}
 
-	LOG_DBG("rx_buf has %d bytes before header skip", data->rx_buf ? data->rx_buf->len : 0);
+	mdata->rx_src_valid = true;
+	return 0;
+}
+
+#ifdef CONFIG_MODEM_IFACE_UART_ASYNC
+/* The async UART interface takes two receive buffers per modem from one pool */
+BUILD_ASSERT(CONFIG_MODEM_IFACE_UART_ASYNC_RX_NUM_BUFFERS >= 2 * MDM_MAX_INSTANCES,
+	     "MODEM_IFACE_UART_ASYNC_RX_NUM_BUFFERS below two per SIM800L instance");
+#endif
 
-	/* Read remaining data from UART with retry logic */
-	int retry_count = 0;
+/*
+ * Read data_len payload bytes from the UART into dst, after skip bytes of
+ * the header. Bytes that do not fit are still read so the command parser
+ * stays in sync, they are dropped.
+ *
+ * Returns the number of bytes stored in dst.
+ */
+static size_t read_payload(struct sim800l_data *mdata, int sock_id, uint8_t *dst, size_t room,
+			   int data_len, int skip)
+{
 	const int max_retries = 5;
-	int skip = 1;
+	int retry_count = 0;
+	size_t stored = 0;
+	uint8_t chunk[128];
+	int ret;
 
 	while (data_len > 0) {
 		size_t to_read = MIN(data_len + skip, sizeof(chunk));
 		size_t bytes_read;
+		size_t fit;
 
-		ret = mdata.ctx.iface.read(&mdata.ctx.iface, chunk, to_read, &bytes_read);
+		ret = mdata->ctx.iface.read(&mdata->ctx.iface, chunk, to_read, &bytes_read);
 		if (ret < 0) {
 			LOG_ERR("Socket %d read error: %d", sock_id, ret);
 			break;
@@ -308,7 +337,7 @@ MODEM_CMD_DEFINE(on_urc_receive)
 			/* Data may still be arriving at 9600 baud */
 			if (retry_count < max_retries) {
 				retry_count++;
-				k_sleep(K_MSEC(10));
+				modem_iface_uart_rx_wait(&mdata->ctx.iface, K_MSEC(10));
 				continue;
 			} else {
 				LOG_WRN("Socket %d no more data after %d retries", sock_id,
@@ -320,30 +349,183 @@ MODEM_CMD_DEFINE(on_urc_receive)
 		/* Got data - reset retry counter */
 		retry_count = 0;
 
-		/* Append to socket RX buffer */
-		if (net_buf_tailroom(sock_data->rx_buf) < bytes_read) {
-			LOG_ERR("Socket %d RX buffer overflow", sock_id);
-			break;
-		}
 		LOG_HEXDUMP_DBG(chunk, bytes_read, "Received chunk:");
-		net_buf_add_mem(sock_data->rx_buf, chunk + skip, bytes_read - skip);
-		sock_data->buffered += bytes_read - skip;
+
+		fit = MIN(room - stored, bytes_read - skip);
+		if (fit < bytes_read - skip) {
+			LOG_ERR("Socket %d RX buffer overflow, dropped %zu bytes", sock_id,
+				bytes_read - skip - fit);
+		}
+
+		if (fit > 0) {
+			memcpy(dst + stored, chunk + skip, fit);
+			stored += fit;
+		}
+
 		data_len -= bytes_read - skip;
 		skip = 0;
 	}
 
-	k_mutex_unlock(&sock_data->lock);
+	return stored;
+}
 
-	LOG_DBG("Socket %d buffered %zu bytes", sock_id, sock_data->buffered);
-	if (sock_data->buffered > 0) {
-		/* Signal data is ready */
-		modem_socket_packet_size_update(&mdata.socket_config, sock, sock_data->buffered);
-		modem_socket_data_ready(&mdata.socket_config, sock);
+/*
+ * Read a binary payload following a response header from the UART into
+ * dst, see read_payload(). The payload starts after the '\n' terminating
+ * the header.
+ */
+size_t modem_read_payload(struct sim800l_data *mdata, int sock_id, uint8_t *dst, size_t room,
+			  int data_len)
+{
+	return read_payload(mdata, sock_id, dst, room, data_len, 1);
+}
+
+/*
+ * Read a binary payload following a response header into a chain of
+ * buffers from pool. Returns NULL when a buffer could not be allocated,
+ * the rest of the payload is read and dropped then.
+ */
+static struct net_buf *read_payload_frags(struct sim800l_data *mdata, int sock_id,
+					  struct net_buf_pool *pool, int data_len)
+{
+	struct net_buf *head = NULL;
+	struct net_buf *frag;
+	int skip = 1;
+	size_t len;
+
+	while (data_len > 0) {
+		frag = net_buf_alloc(pool, K_NO_WAIT);
+		if (!frag) {
+			LOG_ERR("Socket %d RX buffer alloc failed", sock_id);
+			read_payload(mdata, sock_id, NULL, 0, data_len, skip);
+			if (head) {
+				net_buf_unref(head);
+			}
+			return NULL;
+		}
+
+		len = MIN(net_buf_tailroom(frag), (size_t)data_len);
+		net_buf_add(frag, read_payload(mdata, sock_id, net_buf_tail(frag), len, len, skip));
+		skip = 0;
+		data_len -= len;
+
+		if (head) {
+			net_buf_frag_add(head, frag);
+		} else {
+			head = frag;
+		}
 	}
 
+	return head;
+}
+
+/*
+ * URC: +RECEIVE,<n>,<data length>:\r\n<data>
+ *
+ * The payload is read into a buffer chain of its own with the sender in the
+ * user data of the first buffer. SO_RCVBUF is checked when it is appended to
+ * the socket on the URC work queue, the RX thread does not wait for the
+ * socket lock.
+ */
+MODEM_CMD_DEFINE(on_urc_receive)
+{
+	struct sim800l_data *mdata = data->user_data;
+	struct modem_socket *sock;
+	struct net_buf *buf;
+	int sock_id;
+	int data_len;
+
+	sock_id = atoi(argv[0]);
+	data_len = atoi(argv[1]);
+
+	LOG_DBG("+RECEIVE: socket %d, length %d", sock_id, data_len);
+
+	/* Find the socket */
+	sock = modem_socket_from_id(&mdata->socket_config, sock_id);
+	if (!sock) {
+		LOG_WRN("Received data for unknown socket %d", sock_id);
+		modem_read_payload(mdata, sock_id, NULL, 0, data_len);
+		mdata->rx_src_valid = false;
+		return 0;
+	}
+
+	buf = read_payload_frags(mdata, sock_id, data->buf_pool, data_len);
+	if (!buf) {
+		mdata->rx_src_valid = false;
+		/* A stream with a hole is of no use */
+		if (data_len > 0 && sock->type == SOCK_STREAM) {
+			modem_urc_lost(mdata, sock_id);
+		}
+		return 0;
+	}
+
+	/* Without a RECV FROM header the peer is the connected address */
+	memcpy(net_buf_user_data(buf),
+	       mdata->rx_src_valid ? (struct sockaddr *)&mdata->rx_src : &sock->dst,
+	       sizeof(struct sockaddr_in));
+	mdata->rx_src_valid = false;
+
+	modem_urc_data(mdata, sock_id, buf);
 	return 0;
 }
 
+/*
+ * URC: <n>, REMOTE IP: <ip>
+ *
+ * A client connected to the TCP server on link <n>. The link number is only
+ * part of the prefix, so one handler is registered per link. The socket is
+ * set up on the URC work queue.
+ */
+#define ON_URC_REMOTE_IP_DEFINE(n)                                                                 \
+	MODEM_CMD_DEFINE(on_urc_remote_ip_##n)                                                     \
+	{                                                                                          \
+		modem_urc_remote_ip(data->user_data, n, (char *)argv[0]);                          \
+		return 0;                                                                          \
+	}
+
+ON_URC_REMOTE_IP_DEFINE(0)
+ON_URC_REMOTE_IP_DEFINE(1)
+ON_URC_REMOTE_IP_DEFINE(2)
+ON_URC_REMOTE_IP_DEFINE(3)
+ON_URC_REMOTE_IP_DEFINE(4)
+
+/*
+ * URC: <n>, CLOSED
+ *
+ * The peer or the network closed link <n>. Queued behind the data received
+ * before it.
+ */
+#define ON_URC_CLOSED_DEFINE(n)                                                                    \
+	MODEM_CMD_DEFINE(on_urc_closed_##n)                                                        \
+	{                                                                                          \
+		modem_urc_closed(data->user_data, n);                                              \
+		return 0;                                                                          \
+	}
+
+ON_URC_CLOSED_DEFINE(0)
+ON_URC_CLOSED_DEFINE(1)
+ON_URC_CLOSED_DEFINE(2)
+ON_URC_CLOSED_DEFINE(3)
+ON_URC_CLOSED_DEFINE(4)
+
+/*
+ * URC: <n>, CONNECT OK|FAIL, <n>, ALREADY CONNECT or <n>, SEND OK|FAIL
+ *
+ * Completes the CIPSTART or CIPSEND pending on link <n>.
+ */
+#define ON_URC_RESULT_DEFINE(n)                                                                    \
+	MODEM_CMD_DEFINE(on_urc_result_##n)                                                        \
+	{                                                                                          \
+		modem_socket_result(data->user_data, n, (char *)argv[0]);                          \
+		return 0;                                                                          \
+	}
+
+ON_URC_RESULT_DEFINE(0)
+ON_URC_RESULT_DEFINE(1)
+ON_URC_RESULT_DEFINE(2)
+ON_URC_RESULT_DEFINE(3)
+ON_URC_RESULT_DEFINE(4)
+
 /*
  * Handler for RSSI query.
  *
@@ -354,21 +536,22 @@ MODEM_CMD_DEFINE(on_urc_receive)
  */
 MODEM_CMD_DEFINE(on_cmd_csq)
 {
+	struct sim800l_data *mdata = data->user_data;
 	int rssi = atoi(argv[0]);
 
 	if (rssi == 0) {
-		mdata.rssi = -115;
+		mdata->rssi = -115;
 	} else if (rssi == 1) {
-		mdata.rssi = -111;
+		mdata->rssi = -111;
 	} else if (rssi > 1 && rssi < 31) {
-		mdata.rssi = -114 + 2 * rssi;
+		mdata->rssi = -114 + 2 * rssi;
 	} else if (rssi == 31) {
-		mdata.rssi = -52;
+		mdata->rssi = -52;
 	} else {
-		mdata.rssi = -1000;
+		mdata->rssi = -1000;
 	}
 
-	LOG_DBG("RSSI: %d", mdata.rssi);
+	LOG_DBG("RSSI: %d", mdata->rssi);
 	return 0;
 }
 
@@ -385,24 +568,76 @@ static const struct modem_cmd response_cmds[] = {
 static const struct modem_cmd unsolicited_cmds[] = {
 	MODEM_CMD("+PDP: DEACT", on_urc_pdp_deact, 0U, ""),
 	MODEM_CMD("+FTPGET: 1,", on_urc_ftpget, 1U, ""),
+#ifdef CONFIG_MODEM_SIM800L_HTTP
+	MODEM_CMD("+HTTPACTION: ", on_urc_httpaction, 3U, ","),
+#endif
 	MODEM_CMD("RDY", on_urc_rdy, 0U, ""),
 	MODEM_CMD("NORMAL POWER DOWN", on_urc_pwr_down, 0U, ""),
-	// MODEM_CMD("*PSUTTZ: ", on_psuttz, 7U, ","),
+#ifdef CONFIG_MODEM_SIM800L_TIME
+	MODEM_CMD_ARGS_MAX("*PSUTTZ: ", on_urc_psuttz, 7U, 8U, ","),
+#endif
 	MODEM_CMD("+CIEV: ", on_urc_ciev, 0U, ","),
-	MODEM_CMD("+CREG: ", on_urc_creg, 1U, ","),
+	MODEM_CMD_ARGS_MAX("+CREG: ", on_urc_creg, 1U, 2U, ","),
 	MODEM_CMD("+CPIN: ", on_urc_cpin, 1U, ","),
 	MODEM_CMD("+RECEIVE,", on_urc_receive, 2U, ","),
+	MODEM_CMD("RECV FROM:", on_urc_recv_from, 1U, ""),
+	MODEM_CMD("0, REMOTE IP: ", on_urc_remote_ip_0, 1U, ""),
+	MODEM_CMD("1, REMOTE IP: ", on_urc_remote_ip_1, 1U, ""),
+	MODEM_CMD("2, REMOTE IP: ", on_urc_remote_ip_2, 1U, ""),
+	MODEM_CMD("3, REMOTE IP: ", on_urc_remote_ip_3, 1U, ""),
+	MODEM_CMD("4, REMOTE IP: ", on_urc_remote_ip_4, 1U, ""),
+	MODEM_CMD("0, CLOSED", on_urc_closed_0, 0U, ""),
+	MODEM_CMD("1, CLOSED", on_urc_closed_1, 0U, ""),
+	MODEM_CMD("2, CLOSED", on_urc_closed_2, 0U, ""),
+	MODEM_CMD("3, CLOSED", on_urc_closed_3, 0U, ""),
+	MODEM_CMD("4, CLOSED", on_urc_closed_4, 0U, ""),
+	MODEM_CMD("0, CONNECT ", on_urc_result_0, 1U, ""),
+	MODEM_CMD("1, CONNECT ", on_urc_result_1, 1U, ""),
+	MODEM_CMD("2, CONNECT ", on_urc_result_2, 1U, ""),
+	MODEM_CMD("3, CONNECT ", on_urc_result_3, 1U, ""),
+	MODEM_CMD("4, CONNECT ", on_urc_result_4, 1U, ""),
+	MODEM_CMD("0, ALREADY ", on_urc_result_0, 1U, ""),
+	MODEM_CMD("1, ALREADY ", on_urc_result_1, 1U, ""),
+	MODEM_CMD("2, ALREADY ", on_urc_result_2, 1U, ""),
+	MODEM_CMD("3, ALREADY ", on_urc_result_3, 1U, ""),
+	MODEM_CMD("4, ALREADY ", on_urc_result_4, 1U, ""),
+	MODEM_CMD("0, SEND ", on_urc_result_0, 1U, ""),
+	MODEM_CMD("1, SEND ", on_urc_result_1, 1U, ""),
+	MODEM_CMD("2, SEND ", on_urc_result_2, 1U, ""),
+	MODEM_CMD("3, SEND ", on_urc_result_3, 1U, ""),
+	MODEM_CMD("4, SEND ", on_urc_result_4, 1U, ""),
 };
 
 /*
  * Commands to be sent at setup.
  */
 static const struct setup_cmd setup_cmds[] = {
+	SETUP_CMD("AT+CIMI", "", on_cmd_cimi, 0U, ""),
+	SETUP_CMD("AT+CCID", "", on_cmd_ccid, 0U, ""),
+	/* Report registration changes with +CREG: <stat> */
+	SETUP_CMD_NOHANDLE("AT+CREG=1"),
+	/* Numeric operator in +COPS: responses */
+	SETUP_CMD_NOHANDLE("AT+COPS=3,2"),
+#ifdef CONFIG_MODEM_SIM800L_TIME
+	/* Network time as *PSUTTZ and into the modem RTC */
+	SETUP_CMD_NOHANDLE("AT+CLTS=1"),
+#endif
+};
+
+/*
+ * Identity of the module, only read when it is not known from an earlier
+ * boot or the settings, or the IMEI shows another module.
+ */
+static const struct setup_cmd identity_cmds[] = {
 	SETUP_CMD("AT+CGMI", "", on_cmd_cgmi, 0U, ""),
 	SETUP_CMD("AT+CGMM", "", on_cmd_cgmm, 0U, ""),
 	SETUP_CMD("AT+CGMR", "", on_cmd_cgmr, 0U, ""),
 	SETUP_CMD("AT+CGSN", "", on_cmd_cgsn, 0U, ""),
+};
 
+/* Check of a cached identity */
+static const struct setup_cmd imei_cmds[] = {
+	SETUP_CMD("AT+CGSN", "", on_cmd_cgsn, 0U, ""),
 };
 
 static int modem_reset(const struct device *dev)
@@ -475,40 +710,78 @@ static int modem_power_off(const struct device *dev)
 		LOG_DBG("SIM800L held in reset state");
 	}
 
+	modem_monitor_stop(data);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_stop(data);
+#endif
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	modem_sleep_stop(data);
+#endif
+	modem_links_reset(data);
 	data->powered = false;
+	data->status_flags = 0;
+	data->state = SIM800L_STATE_IDLE;
+	modem_link_update(data);
 	LOG_DBG("Modem disabled");
 
 	return 0;
 }
 
-void modem_query_rssi(void)
+void modem_query_rssi(struct sim800l_data *mdata, enum modem_at_class cls)
 {
 	struct modem_cmd cmd[] = {MODEM_CMD("+CSQ: ", on_cmd_csq, 2U, ",")};
 	static char *send_cmd = "AT+CSQ";
 	int ret;
 
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, cmd, ARRAY_SIZE(cmd),
-			     send_cmd, &mdata.sem_response, MDM_CMD_TIMEOUT);
+	ret = modem_at_cmd(mdata, cls, cmd, ARRAY_SIZE(cmd), send_cmd);
 	if (ret < 0) {
 		LOG_ERR("AT+CSQ ret:%d", ret);
 	}
 }
 
-#ifdef CONFIG_PM_DEVICE
+/* Not under a running bring-up or a busy AT channel, runtime PM tries again then */
+static int modem_suspend(const struct device *dev)
+{
+	struct sim800l_data *data = dev->data;
+	int ret = -ENOTSUP;
+
+	if (k_mutex_lock(&data->up_lock, K_NO_WAIT) < 0) {
+		return -EBUSY;
+	}
+
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	/* Sleep registered when possible, a resume needs no boot then */
+	ret = modem_sleep_suspend(data);
+#endif
+	/* Without sleep the modem is held in reset, a busy one is left alone */
+	if (ret == -ENOTSUP) {
+		ret = modem_power_off(dev);
+	}
+
+	if (ret < 0 && ret != -EBUSY) {
+		LOG_ERR("Failed to suspend SIM800L: %d", ret);
+	}
+
+	k_mutex_unlock(&data->up_lock);
+	return ret;
+}
+
 static int modem_pm_action(const struct device *dev, enum pm_device_action action)
 {
 	int ret = 0;
 
 	switch (action) {
 	case PM_DEVICE_ACTION_SUSPEND:
-		ret = modem_power_off(dev);
-		if (ret < 0) {
-			LOG_ERR("Failed to suspend SIM800L: %d", ret);
-		}
-
+		ret = modem_suspend(dev);
 		break;
 
 	case PM_DEVICE_ACTION_RESUME:
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+		/* Still asleep and registered, the next command wakes it */
+		if (modem_sleep_resume(dev->data) == 0) {
+			break;
+		}
+#endif
 		ret = modem_power_on(dev);
 		if (ret < 0) {
 			LOG_ERR("Failed to resume SIM800L: %d", ret);
@@ -523,23 +796,26 @@ static int modem_pm_action(const struct device *dev, enum pm_device_action actio
 
 	return ret;
 }
-#endif /* CONFIG_PM_DEVICE */
 
 /*
  * Process all messages received from the modem.
  */
 static void modem_rx(void *p1, void *p2, void *p3)
 {
-	ARG_UNUSED(p1);
+	struct sim800l_data *mdata = p1;
+
 	ARG_UNUSED(p2);
 	ARG_UNUSED(p3);
 
 	while (true) {
 		/* Wait for incoming UART data */
-		modem_iface_uart_rx_wait(&mdata.ctx.iface, K_FOREVER);
+		modem_iface_uart_rx_wait(&mdata->ctx.iface, K_FOREVER);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+		mdata->health.last_rx = k_uptime_get();
+#endif
 
 		/* Process AT command responses and unsolicited messages */
-		modem_cmd_handler_process(&mdata.ctx.cmd_handler, &mdata.ctx.iface);
+		modem_cmd_handler_process(&mdata->ctx.cmd_handler, &mdata->ctx.iface);
 
 		/* give up time if we have a solid stream of data */
 		k_yield();
@@ -551,14 +827,14 @@ static void modem_rx(void *p1, void *p2, void *p3)
  *
  * @return On successful boot 0 is returned. Otherwise <0 is returned.
  */
-static int modem_autobaud(void)
+static int modem_autobaud(struct sim800l_data *mdata)
 {
 	int boot_tries = 0;
 	int counter = 0;
 	int ret = 0;
 
 	while (boot_tries++ <= MDM_BOOT_TRIES) {
-		modem_reset(mdata.ctx.iface.dev);
+		modem_reset(mdata->dev);
 
 		/*
 		 * The sim7080 has a autobaud function.
@@ -567,14 +843,14 @@ static int modem_autobaud(void)
 		 */
 		counter = 0;
 		while (counter < MDM_MAX_AUTOBAUD) {
-			ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, NULL, 0U,
-					     "AT", &mdata.sem_response, MDM_CMD_TIMEOUT);
+			ret = modem_cmd_send(&mdata->ctx.iface, &mdata->ctx.cmd_handler, NULL, 0U,
+					     "AT", &mdata->sem_response, MDM_CMD_TIMEOUT);
 
 			/* OK was received. */
 			if (ret == 0) {
 				/* Disable echo */
-				return modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler,
-						      NULL, 0U, "ATE0", &mdata.sem_response,
+				return modem_cmd_send(&mdata->ctx.iface, &mdata->ctx.cmd_handler,
+						      NULL, 0U, "ATE0", &mdata->sem_response,
 						      MDM_CMD_TIMEOUT);
 			}
 			counter++;
@@ -583,44 +859,78 @@ static int modem_autobaud(void)
 	return ret;
 }
 
-static int modem_boot(void)
+/* The boot sequence, called with the AT channel held */
+static int modem_boot_run(struct sim800l_data *mdata)
 {
+	char imei[MDM_IMEI_LENGTH];
 	int ret = 0;
 
-	LOG_DBG("Booting modem");
-
-	k_work_cancel_delayable(&mdata.rssi_query_work);
+	/* A reset restores the modem SSL defaults */
+	mdata->ssl_enabled = false;
+	mdata->ssl_ignore_cert = -1;
+	modem_keepalive_default(&mdata->keepalive);
 
-	ret = modem_autobaud();
+	ret = modem_autobaud(mdata);
 	if (ret != 0) {
 		LOG_ERR("Modem autobaud failed");
 		return ret;
 	}
 
-	k_sem_reset(&mdata.boot_sem);
-	ret = k_sem_take(&mdata.boot_sem, K_SECONDS(5));
+	k_sem_reset(&mdata->boot_sem);
+	ret = k_sem_take(&mdata->boot_sem, K_SECONDS(5));
 	if (ret != 0) {
 		LOG_ERR("Timeout while waiting for RDY");
 		return ret;
 	}
 
 	/* Wait for sim card status */
-	ret = k_sem_take(&mdata.boot_sem, K_SECONDS(10));
+	ret = k_sem_take(&mdata->boot_sem, K_SECONDS(10));
 	if (ret != 0) {
 		LOG_ERR("Timeout while waiting for sim status");
 		return ret;
 	}
 
-	if ((mdata.status_flags & SIM800L_STATUS_FLAG_CPIN_READY) == 0) {
+	if ((mdata->status_flags & SIM800L_STATUS_FLAG_CPIN_READY) == 0) {
 		LOG_ERR("Sim card not ready!");
 		return -EIO;
 	}
 
-	mdata.state = SIM800L_STATE_READY;
+	mdata->state = SIM800L_STATE_READY;
+
+	/* A cached identity is checked against the IMEI of the module */
+	strcpy(imei, mdata->imei);
+	if (imei[0] != '\0') {
+		ret = modem_cmd_handler_setup_cmds(&mdata->ctx.iface, &mdata->ctx.cmd_handler,
+						   imei_cmds, ARRAY_SIZE(imei_cmds),
+						   &mdata->sem_response, MDM_CMD_TIMEOUT);
+		if (ret < 0) {
+			LOG_ERR("Failed to read IMEI!");
+			return ret;
+		}
+	}
+
+	if (imei[0] == '\0' || strcmp(imei, mdata->imei) != 0) {
+		if (imei[0] != '\0') {
+			/* The MAC address keeps the old IMEI until the next init */
+			LOG_WRN("Module replaced, IMEI was %s", imei);
+		}
+
+		ret = modem_cmd_handler_setup_cmds(&mdata->ctx.iface, &mdata->ctx.cmd_handler,
+						   identity_cmds, ARRAY_SIZE(identity_cmds),
+						   &mdata->sem_response, MDM_CMD_TIMEOUT);
+		if (ret < 0) {
+			LOG_ERR("Failed to read modem identity!");
+			return ret;
+		}
+
+#ifdef CONFIG_MODEM_SIM800L_SETTINGS
+		modem_settings_save_identity(mdata);
+#endif
+	}
 
 	/* Send setup commands */
-	ret = modem_cmd_handler_setup_cmds(&mdata.ctx.iface, &mdata.ctx.cmd_handler, setup_cmds,
-					   ARRAY_SIZE(setup_cmds), &mdata.sem_response,
+	ret = modem_cmd_handler_setup_cmds(&mdata->ctx.iface, &mdata->ctx.cmd_handler, setup_cmds,
+					   ARRAY_SIZE(setup_cmds), &mdata->sem_response,
 					   MDM_REGISTRATION_TIMEOUT);
 	if (ret < 0) {
 		LOG_ERR("Failed to send init commands!");
@@ -629,67 +939,219 @@ static int modem_boot(void)
 
 	k_sleep(K_SECONDS(3));
 
-	ret = modem_pdp_activate();
+	modem_operator_hint(mdata);
+
+	ret = modem_pdp_activate(mdata);
 	if (ret < 0) {
 		LOG_ERR("Failed to activate PDP context: %d", ret);
 		return ret;
 	}
 
+#ifdef CONFIG_MODEM_SIM800L_TIME
+	modem_time_query(mdata);
+#endif
+
+	return 0;
+}
+
+static int modem_boot(struct sim800l_data *mdata)
+{
+	int ret;
+
+	LOG_DBG("Booting modem");
+
+	modem_monitor_stop(mdata);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_stop(mdata);
+#endif
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	modem_sleep_stop(mdata);
+#endif
+
+	/*
+	 * Hold the channel from the autobaud to the PDP context, nothing may
+	 * send in between. Every owner returns it within its response timeout.
+	 */
+	ret = modem_at_acquire(mdata, MDM_AT_CONTROL, sys_timepoint_calc(K_FOREVER));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = modem_boot_run(mdata);
+	modem_at_release(mdata);
+	if (ret < 0) {
+		return ret;
+	}
+
+	mdata->status_flags |= SIM800L_STATUS_FLAG_BOOTED;
+	modem_monitor_start(mdata);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_start(mdata);
+#endif
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	modem_sleep_start(mdata);
+#endif
+
 	LOG_INF("Modem boot complete");
 	return ret;
 }
 
-static int modem_init(const struct device *dev)
+static int bring_up(struct sim800l_data *mdata)
+{
+	int ret;
+
+	if (!mdata->powered) {
+		ret = modem_power_on(mdata->dev);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* A runtime PM resume only powers the modem on */
+	if ((mdata->status_flags & SIM800L_STATUS_FLAG_BOOTED) == 0) {
+		return modem_boot(mdata);
+	}
+
+	if (mdata->status_flags & SIM800L_STATUS_FLAG_PDP_ACTIVE) {
+		return 0;
+	}
+
+	return modem_pdp_activate(mdata);
+}
+
+/*
+ * Bring the modem up to an active PDP context, powering and booting it
+ * first when needed. Lazy users, the connection manager and the health
+ * monitor call it from different threads. One runs at a time, and the
+ * state is checked again once the previous one is done.
+ */
+int modem_bring_up(struct sim800l_data *mdata)
 {
+	int ret;
+
+	k_mutex_lock(&mdata->up_lock, K_FOREVER);
+	ret = bring_up(mdata);
+	k_mutex_unlock(&mdata->up_lock);
+
+	return ret;
+}
+
+/* Reset and boot the modem again, the last resort of the health monitor */
+int modem_reboot(struct sim800l_data *mdata)
+{
+	int ret;
+
+	LOG_WRN("Rebooting modem");
+
+	k_mutex_lock(&mdata->up_lock, K_FOREVER);
+	modem_power_off(mdata->dev);
+	ret = bring_up(mdata);
+	k_mutex_unlock(&mdata->up_lock);
+
+	return ret;
+}
+
+static const struct k_work_queue_config ctl_workq_cfg = {
+	.name = "modem_ctl",
+};
 
+static int modem_init(const struct device *dev)
+{
+	struct sim800l_data *mdata = dev->data;
+	const struct sim800l_config *mconfig = dev->config;
 	int ret;
 
-	LOG_DBG("Initializing modem");
+	LOG_DBG("Initializing modem %s", dev->name);
 
-	mdata.status_flags = 0;
+	mdata->dev = dev;
+	mdata->status_flags = 0;
+	strncpy(mdata->apn, CONFIG_MODEM_SIM800L_APN, sizeof(mdata->apn) - 1);
 
-	k_sem_init(&mdata.sem_tx_ready, 0, 1);
-	k_sem_init(&mdata.sem_response, 0, 1);
-	k_sem_init(&mdata.sem_dns, 0, 1);
-	k_sem_init(&mdata.sem_sock_conn, 0, 1);
-	k_sem_init(&mdata.boot_sem, 0, 1);
+#ifdef CONFIG_MODEM_SIM800L_SETTINGS
+	/* Before the boot, which skips the identity and hints the operator */
+	modem_settings_load(mdata);
+#endif
+
+	k_sem_init(&mdata->sem_tx_ready, 0, 1);
+	k_sem_init(&mdata->sem_response, 0, 1);
+	k_sem_init(&mdata->sem_dns, 0, 1);
+	k_sem_init(&mdata->sem_sock_conn, 0, 1);
+	k_sem_init(&mdata->boot_sem, 0, 1);
+	k_mutex_init(&mdata->up_lock);
 
 	/* Initialize reset GPIO */
-	if (mdata.reset_gpio.port) {
-		if (!gpio_is_ready_dt(&mdata.reset_gpio)) {
+	if (mdata->reset_gpio.port) {
+		if (!gpio_is_ready_dt(&mdata->reset_gpio)) {
 			LOG_ERR("Reset GPIO device not ready");
 			return -ENODEV;
 		}
 
-		ret = gpio_pin_configure_dt(&mdata.reset_gpio, GPIO_OUTPUT_ACTIVE);
+		ret = gpio_pin_configure_dt(&mdata->reset_gpio, GPIO_OUTPUT_ACTIVE);
 		if (ret < 0) {
 			LOG_ERR("Failed to configure reset GPIO: %d", ret);
 			return ret;
 		}
 	}
 
-	/* Socket config. */
-	ret = modem_socket_init(&mdata.socket_config, &mdata.sockets[0], ARRAY_SIZE(mdata.sockets),
-				MDM_BASE_SOCKET_NUM, true, &offload_socket_fd_op_vtable);
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	ret = modem_sleep_init(mdata);
 	if (ret < 0) {
 		return ret;
 	}
+#endif
+
+	/* Socket config. Link IDs are assigned by connect and accept. */
+	ret = modem_socket_init(&mdata->socket_config, &mdata->sockets[0],
+				ARRAY_SIZE(mdata->sockets), MDM_BASE_SOCKET_NUM, false,
+				&offload_socket_fd_op_vtable);
+	if (ret < 0) {
+		return ret;
+	}
+
+	modem_at_init(mdata);
+	modem_rtt_init(mdata);
+	modem_urc_init(mdata, mconfig->urc_stack, mconfig->urc_stack_size);
+	modem_links_init(mdata);
+	modem_server_init(mdata);
+	modem_monitor_init(mdata);
+	k_work_queue_start(&mdata->ctl_workq, mconfig->ctl_stack, mconfig->ctl_stack_size,
+			   K_PRIO_PREEMPT(CONFIG_MODEM_SIM800L_URC_PRIORITY + 1), &ctl_workq_cfg);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_init(mdata);
+#endif
+#ifdef CONFIG_MODEM_SIM800L_TIME
+	modem_time_init(mdata);
+#endif
+	modem_link_init(mdata);
+#ifdef CONFIG_MODEM_SIM800L_FTP
+	modem_ftp_init(mdata);
+#endif
+#ifdef CONFIG_MODEM_SIM800L_HTTP
+	modem_http_init(mdata);
+#endif
+
+	for (int i = 0; i < ARRAY_SIZE(mdata->socket_data); i++) {
+		mdata->socket_data[i].mdata = mdata;
+		k_mutex_init(&mdata->socket_data[i].lock);
+		k_fifo_init(&mdata->socket_data[i].dgram_q);
+		k_sem_init(&mdata->socket_data[i].sem_result, 0, 1);
+	}
 
 	/* Command handler. */
 	const struct modem_cmd_handler_config cmd_handler_config = {
-		.match_buf = &mdata.cmd_match_buf[0],
-		.match_buf_len = sizeof(mdata.cmd_match_buf),
-		.buf_pool = &mdm_recv_pool,
+		.match_buf = &mdata->cmd_match_buf[0],
+		.match_buf_len = sizeof(mdata->cmd_match_buf),
+		.buf_pool = mconfig->recv_pool,
 		.alloc_timeout = BUF_ALLOC_TIMEOUT,
 		.eol = "\r\n",
-		.user_data = NULL,
+		.user_data = mdata,
 		.response_cmds = response_cmds,
 		.response_cmds_len = ARRAY_SIZE(response_cmds),
 		.unsol_cmds = unsolicited_cmds,
 		.unsol_cmds_len = ARRAY_SIZE(unsolicited_cmds),
 	};
 
-	ret = modem_cmd_handler_init(&mdata.ctx.cmd_handler, &mdata.cmd_handler_data,
+	ret = modem_cmd_handler_init(&mdata->ctx.cmd_handler, &mdata->cmd_handler_data,
 				     &cmd_handler_config);
 	if (ret < 0) {
 		return ret;
@@ -697,62 +1159,136 @@ static int modem_init(const struct device *dev)
 
 	/* Uart handler. */
 	const struct modem_iface_uart_config uart_config = {
-		.rx_rb_buf = &mdata.iface_rb_buf[0],
-		.rx_rb_buf_len = sizeof(mdata.iface_rb_buf),
-		.dev = mconfig.uart,
+		.rx_rb_buf = &mdata->iface_rb_buf[0],
+		.rx_rb_buf_len = sizeof(mdata->iface_rb_buf),
+		.dev = mconfig->uart,
 		.hw_flow_control = false,
 	};
 
-	ret = modem_iface_uart_init(&mdata.ctx.iface, &mdata.iface_data, &uart_config);
+	ret = modem_iface_uart_init(&mdata->ctx.iface, &mdata->iface_data, &uart_config);
 	if (ret < 0) {
 		return ret;
 	}
 
+#ifdef CONFIG_MODEM_SIM800L_CAPTURE
+	modem_capture_init(mdata);
+#endif
+
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	/* Powered and booted by the first socket or lookup */
+	modem_lazy_init(mdata);
+#else
 	ret = modem_power_on(dev);
 	if (ret < 0) {
 		LOG_ERR("Failed to power on modem: %d", ret);
 		return ret;
 	}
+#endif
 #ifdef CONFIG_PM_DEVICE
 	pm_device_init_suspended(dev);
 #endif /* CONFIG_PM_DEVICE */
 
 	/* Modem data storage. */
-	mdata.ctx.data_manufacturer = mdata.manufacturer;
-	mdata.ctx.data_model = mdata.model;
-	mdata.ctx.data_revision = mdata.revision;
-	mdata.ctx.data_imei = mdata.imei;
-	mdata.ctx.driver_data = &mdata;
-	ret = modem_context_register(&mdata.ctx);
+	mdata->ctx.data_manufacturer = mdata->manufacturer;
+	mdata->ctx.data_model = mdata->model;
+	mdata->ctx.data_revision = mdata->revision;
+	mdata->ctx.data_imei = mdata->imei;
+	mdata->ctx.driver_data = mdata;
+	ret = modem_context_register(&mdata->ctx);
 	if (ret < 0) {
 		LOG_ERR("Error registering modem context: %d", ret);
 		return ret;
 	}
 
-	k_tid_t tid = k_thread_create(&modem_rx_thread, modem_rx_stack,
-				      K_KERNEL_STACK_SIZEOF(modem_rx_stack), modem_rx, NULL, NULL,
-				      NULL, K_PRIO_COOP(7), 0, K_NO_WAIT);
+	k_tid_t tid = k_thread_create(&mdata->rx_thread, mconfig->rx_stack,
+				      mconfig->rx_stack_size, modem_rx, mdata, NULL, NULL,
+				      K_PRIO_COOP(7), 0, K_NO_WAIT);
 
 	k_thread_name_set(tid, "modem_rx");
 	k_sleep(K_MSEC(100));
 
-	return modem_boot();
-}
-
-#ifdef CONFIG_PM_DEVICE
-PM_DEVICE_DT_INST_DEFINE(0, modem_pm_action);
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+	return pm_device_runtime_enable(dev);
+#else
+	return 0;
 #endif
-
-#define MODEM_SIMCOM_SIM800L_INIT_PRIORITY 90
+#else
+	return modem_boot(mdata);
+#endif
+}
 
 static struct offloaded_if_api api_funcs = {
 	.iface_api.init = modem_net_iface_init,
 };
 
-// /* Register device with the networking stack. */
-NET_DEVICE_DT_INST_OFFLOAD_DEFINE(0, modem_init, PM_DEVICE_DT_INST_GET(0), &mdata, &mconfig,
-				  CONFIG_GPIO_INIT_PRIORITY, &api_funcs, MDM_MAX_DATA_LENGTH);
+/* The interface device shares the modem data, the modem is set up by modem_init */
+static int modem_net_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
 
-/* Register NET sockets. */
-NET_SOCKET_OFFLOAD_REGISTER(simcom_sim800l, CONFIG_NET_SOCKETS_OFFLOAD_PRIORITY, AF_UNSPEC,
-			    modem_offload_is_supported, modem_offload_socket);
+	return 0;
+}
+
+#ifdef CONFIG_MODEM_SIM800L_CONN_MGR
+#define SIM800L_CONN_BIND(inst)                                                                    \
+	CONN_MGR_BIND_CONN_DATA(sim800l_net_##inst, SIM800L_CONN, &sim800l_data_##inst)
+#else
+#define SIM800L_CONN_BIND(inst)
+#endif
+
+/*
+ * Every instance gets its own context, RX thread, URC work queue, buffer
+ * pool and socket table. The socket create functions are wrapped per
+ * instance and set on its interface, the socket dispatcher creates a socket
+ * bound with SO_BINDTODEVICE through them. Sockets without a binding are
+ * spread over the modems by the one offload registered in sim800l_offload.c.
+ *
+ * The devicetree device implements the cellular API, the offloaded network
+ * interface sits on a second device sharing the same data because a device
+ * has only one API.
+ */
+#define SIM800L_DEVICE_DEFINE(inst)                                                                \
+	NET_BUF_POOL_DEFINE(mdm_recv_pool_##inst, MDM_RECV_MAX_BUF, MDM_RECV_BUF_SIZE,            \
+			    sizeof(struct sockaddr_in), NULL);                                     \
+	static K_KERNEL_STACK_DEFINE(modem_rx_stack_##inst, 2048);                                 \
+	static K_KERNEL_STACK_DEFINE(modem_urc_stack_##inst, CONFIG_MODEM_SIM800L_URC_STACK_SIZE); \
+	static K_KERNEL_STACK_DEFINE(modem_ctl_stack_##inst, CONFIG_MODEM_SIM800L_CTL_STACK_SIZE); \
+                                                                                                   \
+	static struct sim800l_data sim800l_data_##inst = {                                         \
+		.reset_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, mdm_reset_gpios, {}),                 \
+		.dtr_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, mdm_dtr_gpios, {}),                     \
+		.powered = false,                                                                  \
+	};                                                                                         \
+                                                                                                   \
+	static int modem_offload_socket_##inst(int family, int type, int proto)                    \
+	{                                                                                          \
+		return modem_offload_socket(&sim800l_data_##inst, family, type, proto);            \
+	}                                                                                          \
+                                                                                                   \
+	static const struct sim800l_config sim800l_config_##inst = {                               \
+		.uart = DEVICE_DT_GET(DT_INST_BUS(inst)),                                          \
+		.recv_pool = &mdm_recv_pool_##inst,                                                \
+		.rx_stack = modem_rx_stack_##inst,                                                 \
+		.rx_stack_size = K_KERNEL_STACK_SIZEOF(modem_rx_stack_##inst),                     \
+		.urc_stack = modem_urc_stack_##inst,                                               \
+		.urc_stack_size = K_KERNEL_STACK_SIZEOF(modem_urc_stack_##inst),                   \
+		.ctl_stack = modem_ctl_stack_##inst,                                               \
+		.ctl_stack_size = K_KERNEL_STACK_SIZEOF(modem_ctl_stack_##inst),                   \
+		.socket_create = modem_offload_socket_##inst,                                      \
+	};                                                                                         \
+                                                                                                   \
+	PM_DEVICE_DT_INST_DEFINE(inst, modem_pm_action);                                           \
+                                                                                                   \
+	DEVICE_DT_INST_DEFINE(inst, modem_init, PM_DEVICE_DT_INST_GET(inst),                       \
+			      &sim800l_data_##inst, &sim800l_config_##inst, POST_KERNEL,           \
+			      CONFIG_MODEM_SIM800L_INIT_PRIORITY, &sim800l_cellular_api);          \
+                                                                                                   \
+	NET_DEVICE_OFFLOAD_INIT(sim800l_net_##inst, "sim800l_net_" #inst, modem_net_dev_init,      \
+				NULL, &sim800l_data_##inst, &sim800l_config_##inst,                \
+				CONFIG_MODEM_SIM800L_INIT_PRIORITY, &api_funcs,                    \
+				MDM_MAX_DATA_LENGTH);                                              \
+                                                                                                   \
+	SIM800L_CONN_BIND(inst);
+
+DT_INST_FOREACH_STATUS_OKAY(SIM800L_DEVICE_DEFINE)
@@ -15,16 +15,29 @@
 
 #include <modem_context.h>
 #include <modem_iface_uart.h>
+#ifdef CONFIG_MODEM_SIM800L_CAPTURE
+#include <zephyr/sys/ring_buffer.h>
+#endif
 #include <modem_cmd_handler.h>
 #include <modem_socket.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/cellular.h>
 #include <zephyr/net_buf.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/dns_resolve.h>
+#ifdef CONFIG_MODEM_SIM800L_CONN_MGR
+#include <zephyr/net/conn_mgr_connectivity_impl.h>
+#endif
 
 #define BUF_ALLOC_TIMEOUT        K_SECONDS(1)
-#define MDM_DNS_TIMEOUT          K_SECONDS(210)
 #define MDM_REGISTRATION_TIMEOUT K_SECONDS(180)
-#define MDM_CONN_TIMEOUT         K_SECONDS(120)
 #define MDM_CMD_TIMEOUT          K_SECONDS(10)
+#define MDM_BEARER_TIMEOUT       K_SECONDS(85)
+#define MDM_FTP_TIMEOUT          K_SECONDS(75)
+#define MDM_HTTP_TIMEOUT         K_SECONDS(120)
+#define MDM_SHUT_TIMEOUT         K_SECONDS(65)
 #define MDM_WAIT_FOR_RSSI_DELAY  K_SECONDS(2)
+#define MDM_CLOSE_RETRY_DELAY    K_SECONDS(5)
 #define MDM_RSSI_TIMEOUT_SECS    30
 #define MDM_MAX_CGATT_WAITS      30
 
@@ -32,6 +45,8 @@
 #define MDM_MAX_DATA_LENGTH 1024
 
 #define MDM_IMEI_LENGTH     16
+#define MDM_IMSI_LENGTH     16
+#define MDM_ICCID_LENGTH    22
 #define MDM_MODEL_LENGTH    16
 #define MDM_REVISION_LENGTH 64
 /* SIM800L supports total 5 connections (socket IDs 0-4).
@@ -41,13 +56,25 @@
  */
 #define MDM_MAX_SOCKETS     5 /* Total sockets: IDs 0-4 */
 #define MDM_BASE_SOCKET_NUM 0 /* First socket ID */
+/* Link IDs are assigned on connect/accept, this marks a socket without one */
+#define MDM_UNASSIGNED_SOCKET_ID (MDM_BASE_SOCKET_NUM + MDM_MAX_SOCKETS)
 #define MDM_RECV_MAX_BUF    30
 #define MDM_RECV_BUF_SIZE   1024
+/* Default SO_RCVBUF, limits how much of the shared pool one socket holds */
+#define MDM_SOCKET_RCVBUF   (4 * MDM_RECV_BUF_SIZE)
 #define MDM_BOOT_TRIES      3
+/* Deferred URCs, enough for every receive buffer plus a close per link */
+#define MDM_URC_QUEUE_LEN   (MDM_RECV_MAX_BUF + MDM_MAX_SOCKETS)
 
 #define MDM_WAIT_FOR_RSSI_COUNT 30
 
 #define MDM_MANUFACTURER_LENGTH 12
+#define MDM_APN_LENGTH          64
+/* Numeric operator, MCC and a two or three digit MNC */
+#define MDM_OPERATOR_LENGTH     8
+
+/* Number of enabled SIM800L instances in the devicetree */
+#define MDM_MAX_INSTANCES DT_NUM_INST_STATUS_OKAY(simcom_sim800l)
 
 /* SIM800L specific state enum */
 enum sim800l_state {
@@ -63,16 +90,100 @@ enum sim800l_status_flags {
 	SIM800L_STATUS_FLAG_CPIN_READY = 0x02,
 	SIM800L_STATUS_FLAG_ATTACHED = 0x04,
 	SIM800L_STATUS_FLAG_PDP_ACTIVE = 0x08,
+	/* modem_boot() completed since the last power on */
+	SIM800L_STATUS_FLAG_BOOTED = 0x10,
+};
+
+/*
+ * AT request classes in priority order, a free AT channel goes to the
+ * highest class waiting for it. See sim800l_at.c.
+ */
+enum modem_at_class {
+	MDM_AT_DATA = 0,
+	MDM_AT_CONTROL,
+	MDM_AT_MONITOR,
+	MDM_AT_CLASSES,
+};
+
+/* Adaptive timeout classes, see sim800l_rtt.c */
+enum modem_rtt_class {
+	/* Final result code of a quick command */
+	MDM_RTT_CMD = 0,
+	/* '>' prompt after AT+CIPSEND */
+	MDM_RTT_PROMPT,
+	/* <n>, SEND OK after the data */
+	MDM_RTT_SEND,
+	/* <n>, CONNECT OK after AT+CIPSTART */
+	MDM_RTT_CONNECT,
+	/* +CDNSGIP after AT+CDNSGIP */
+	MDM_RTT_DNS,
+	MDM_RTT_CLASSES,
+};
+
+/* Response time estimate of one class, in ms */
+struct sim800l_rtt {
+	bool measured;
+	uint32_t srtt;
+	uint32_t rttvar;
+	/* Current timeout */
+	uint32_t rto;
+};
+
+struct sim800l_data;
+
+/* AT+CIPTKA parameters, the modem applies them to the next TCP connection */
+struct sim800l_keepalive {
+	bool enabled;
+	/* Seconds of idle time before the first probe, 30-7200 */
+	uint16_t idle;
+	/* Seconds between probes, 30-600 */
+	uint16_t intvl;
+	/* Probes before the connection is dropped, 1-9 */
+	uint8_t cnt;
+};
+
+/* URC handed from the RX thread to the URC work queue, see sim800l_urc.c */
+struct modem_urc_event {
+	/* Received payload, the sender is in the user data */
+	struct net_buf *buf;
+	uint8_t type;
+	uint8_t link;
+	/* Peer address of an incoming connection */
+	char ip[NET_IPV4_ADDR_LEN];
 };
 
 struct sim800l_socket_data {
+	/* Modem instance owning the socket */
+	struct sim800l_data *mdata;
+	/* Stream data not yet read, received buffers chained as fragments */
 	struct net_buf *rx_buf;
+	/* UDP datagrams, one net_buf each with the sender in its user data */
+	struct k_fifo dgram_q;
 	size_t buffered;
 	struct k_mutex lock;
+	/* TLS_PEER_VERIFY value, -1 keeps the modem setting */
+	int tls_peer_verify;
+	/* SO_RCVTIMEO and SO_SNDTIMEO in microseconds, 0 waits forever */
+	uint64_t rcvtimeo_us;
+	uint64_t sndtimeo_us;
+	/* O_NONBLOCK set with fcntl() */
+	bool nonblock;
+	/* SO_RCVBUF, a datagram beyond it is dropped, a stream reset */
+	size_t rcvbuf;
+	/* Pending error returned and cleared by SO_ERROR */
+	int error;
+	/* The peer closed the connection, reads end once the buffer drains */
+	bool peer_closed;
+	/* SO_KEEPALIVE and TCP_KEEP* */
+	struct sim800l_keepalive keepalive;
+	/* Result of the pending CIPSTART or CIPSEND, from the link URC */
+	struct k_sem sem_result;
+	int result;
 };
 
 struct sim800l_data {
 	struct modem_context ctx;
+	const struct device *dev;
 	/* Modem status flags */
 	uint32_t status_flags;
 	/*
@@ -87,12 +198,29 @@ struct sim800l_data {
 	struct modem_iface_uart_data iface_data;
 	uint8_t iface_rb_buf[MDM_MAX_DATA_LENGTH];
 
+#ifdef CONFIG_MODEM_SIM800L_CAPTURE
+	/* Raw UART traffic capture, see sim800l_capture.c */
+	struct {
+		struct k_spinlock lock;
+		struct ring_buf rb;
+		uint8_t buf[CONFIG_MODEM_SIM800L_CAPTURE_SIZE];
+		/* Transport functions the capture is wrapped around */
+		int (*read)(struct modem_iface *iface, uint8_t *buf, size_t size,
+			    size_t *bytes_read);
+		int (*write)(struct modem_iface *iface, const uint8_t *buf, size_t size);
+		/* Records dropped to make room since the last dump */
+		uint32_t dropped;
+	} capture;
+#endif
+
 	/*
 	 * Modem socket data.
 	 */
 	struct modem_socket_config socket_config;
 	struct modem_socket sockets[MDM_MAX_SOCKETS];
 	struct sim800l_socket_data socket_data[MDM_MAX_SOCKETS];
+	/* Open sockets, new sockets go to the modem with the fewest */
+	atomic_t sockets_used;
 
 	/* modem cmds */
 	struct modem_cmd_handler_data cmd_handler_data;
@@ -102,6 +230,8 @@ struct sim800l_data {
 	 * Uart interface of the modem.
 	 */
 	const struct gpio_dt_spec reset_gpio;
+	/* DTR line, high lets the modem sleep after AT+CSCLK=1 */
+	const struct gpio_dt_spec dtr_gpio;
 
 	/* DNS related variables */
 	struct {
@@ -109,6 +239,10 @@ struct sim800l_data {
 		uint8_t recount;
 		/* Timeout in milliseconds */
 		uint16_t timeout;
+		/* Result of the last lookup */
+		struct zsock_addrinfo result;
+		struct sockaddr result_addr;
+		char result_canonname[DNS_MAX_NAME_SIZE + 1];
 	} dns;
 
 	/*
@@ -118,6 +252,24 @@ struct sim800l_data {
 	char model[MDM_MODEL_LENGTH];
 	char revision[MDM_REVISION_LENGTH];
 	char imei[MDM_IMEI_LENGTH];
+	char imsi[MDM_IMSI_LENGTH];
+	char iccid[MDM_ICCID_LENGTH];
+	/* Access point name, CONFIG_MODEM_SIM800L_APN unless set at runtime */
+	char apn[MDM_APN_LENGTH];
+	/* Last serving operator and the SIM it was serving */
+	struct {
+		char oper[MDM_OPERATOR_LENGTH];
+		char imsi[MDM_IMSI_LENGTH];
+	} network;
+#ifdef CONFIG_MODEM_SIM800L_SETTINGS
+	/* Operator waiting to be stored, see sim800l_settings.c */
+	struct {
+		struct k_work work;
+		struct k_spinlock lock;
+		char oper[MDM_OPERATOR_LENGTH];
+		char imsi[MDM_IMSI_LENGTH];
+	} settings;
+#endif
 	int rssi;
 	uint8_t network_registration;
 	char ip_addr[16]; /* IPv4 address string */
@@ -125,7 +277,85 @@ struct sim800l_data {
 	bool powered;
 	struct k_work_delayable timeout_work;
 	enum sim800l_state state;
+	/* Network status monitor, see sim800l_monitor.c */
 	struct k_work_delayable rssi_query_work;
+	struct {
+		/* Seconds until the next refresh */
+		uint32_t interval;
+		/* Uptime of the last refresh in ms, -1 before the first */
+		int64_t updated;
+	} monitor;
+
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	/* On demand bring-up, see sim800l_lazy.c */
+	struct {
+		struct k_mutex lock;
+		struct k_condvar done;
+		bool busy;
+		/* Completed bring-ups, waiters wake when it changes */
+		uint32_t gen;
+		int result;
+	} lazy;
+#endif
+
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	/* Slow clock sleep, see sim800l_sleep.c */
+	struct {
+		struct k_work_delayable work;
+		/* AT+CSCLK=1 sent since the last boot */
+		bool enabled;
+		/* DTR is high */
+		bool asleep;
+	} sleep;
+#endif
+
+#ifdef CONFIG_MODEM_SIM800L_TIME
+	/* Network time, see sim800l_time.c */
+	struct {
+		struct k_work work;
+		/* Seconds since the epoch at the uptime in ms of updated */
+		int64_t utc;
+		int64_t updated;
+		/* Local time zone in quarter hours */
+		int tz;
+		/* enum sim800l_time_source */
+		uint8_t source;
+	} time;
+#endif
+
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	/* Stuck modem detection, see sim800l_health.c */
+	struct {
+		struct k_work_delayable work;
+		/* Missed answers in a row */
+		atomic_t timeouts;
+		/* The check owns the channel, its own misses do not reschedule it */
+		atomic_t checking;
+		/* Uptime in ms of the last received data */
+		int64_t last_rx;
+		/* First recovery step of the next recovery */
+		int step;
+		/* Uptime in ms of the last recovery */
+		int64_t recovered;
+	} health;
+#endif
+
+	/* Work queue for the blocking control work, like a boot */
+	struct k_work_q ctl_workq;
+
+	/* AT channel arbiter */
+	struct {
+		struct k_spinlock lock;
+		bool busy;
+		/* Thread holding the channel and its nested acquires */
+		k_tid_t owner;
+		int depth;
+		/* Requests waiting for the channel, one FIFO per class */
+		sys_slist_t waiters[MDM_AT_CLASSES];
+	} at;
+
+	/* Response time estimates */
+	struct sim800l_rtt rtt[MDM_RTT_CLASSES];
 
 	/* Received data tracking */
 	int rx_len;       /* Length of received data */
@@ -140,19 +370,197 @@ struct sim800l_data {
 	struct k_sem sem_sock_conn;
 	struct k_sem sem_dns;
 	struct k_sem boot_sem;
+	/* Serializes power, boot and PDP bring-up, see modem_bring_up() */
+	struct k_mutex up_lock;
+
+	/* Interface state, see modem_link_update() */
+	struct {
+		struct k_work work;
+		bool up;
+		/* Address added to the interface while the link is up */
+		struct in_addr addr;
+	} link;
+
+#ifdef CONFIG_MODEM_SIM800L_CONN_MGR
+	/* Connection manager request */
+	struct {
+		struct conn_mgr_conn_binding *binding;
+		struct k_work_delayable work;
+		/* AT+CIPSHUT for a disconnect */
+		struct k_work shutdown_work;
+		bool requested;
+		/* Uptime in ms the connect times out, 0 for none */
+		int64_t deadline;
+	} conn;
+#endif
+
+	/* Status of the SAPBR bearer used by FTP and HTTP */
+	int bearer_status;
+
+#ifdef CONFIG_MODEM_SIM800L_FTP
+	/* FTP download, one at a time */
+	struct {
+		struct k_mutex lock;
+		struct k_sem sem_urc;
+		/* Code of the last +FTPGET: 1,<code> */
+		int urc;
+		/* The next chunk is read before the current one goes to the caller */
+		uint8_t buf[2][CONFIG_MODEM_SIM800L_FTP_CHUNK_SIZE];
+		size_t len[2];
+		/* Buffer the pending +FTPGET: 2 response is stored in */
+		int fill;
+	} ftp;
+#endif
+
+#ifdef CONFIG_MODEM_SIM800L_HTTP
+	/* HTTP session, owned by one thread from request to close */
+	struct {
+		struct k_mutex lock;
+		struct k_sem sem_action;
+		bool active;
+		/* Result of the last +HTTPACTION */
+		int status;
+		size_t content_len;
+		size_t read_offset;
+		/* Caller buffer the pending +HTTPREAD is stored in */
+		uint8_t *dst;
+		size_t room;
+		size_t got;
+	} http;
+#endif
+
+	/* AT+CIPSSL is global, it applies to the next CIPSTART */
+	bool ssl_enabled;
+	/* Last AT+SSLOPT=0 value sent, -1 if never set */
+	int ssl_ignore_cert;
+	/* Last AT+CIPTKA setting, global like AT+CIPSSL */
+	struct sim800l_keepalive keepalive;
+
+	/* Sender of the next +RECEIVE payload, from RECV FROM */
+	struct sockaddr_in rx_src;
+	bool rx_src_valid;
+
+	/* Thread processing the modem responses */
+	struct k_thread rx_thread;
+
+	/* Work queue running the URC handlers that may block */
+	struct {
+		struct k_work_q workq;
+		struct k_work work;
+		struct k_msgq q;
+		char q_buf[MDM_URC_QUEUE_LEN * sizeof(struct modem_urc_event)];
+	} urc;
+
+	/* Serializes link ID assignment between connect and accept */
+	struct k_mutex link_lock;
+	/* Links being closed in the background, not assigned until confirmed */
+	atomic_t closing_links;
+	struct k_work_delayable close_work;
+
+	/* TCP server, the modem supports a single listening socket */
+	struct {
+		struct modem_socket *sock;
+		/* listen() backlog, connections waiting beyond it are rejected */
+		int backlog;
+		/* File descriptors of accepted connections */
+		struct k_msgq accept_q;
+		char accept_q_buf[MDM_MAX_SOCKETS * sizeof(int)];
+	} server;
 };
 
 struct sim800l_config {
 	const struct device *uart;
+	struct net_buf_pool *recv_pool;
+	k_thread_stack_t *rx_stack;
+	size_t rx_stack_size;
+	k_thread_stack_t *urc_stack;
+	size_t urc_stack_size;
+	k_thread_stack_t *ctl_stack;
+	size_t ctl_stack_size;
+	/* Per instance socket create function, bound to the interface */
+	int (*socket_create)(int family, int type, int proto);
 };
 
-int modem_pdp_activate(void);
+void modem_at_init(struct sim800l_data *mdata);
+int modem_at_acquire(struct sim800l_data *mdata, enum modem_at_class cls, k_timepoint_t deadline);
+void modem_at_release(struct sim800l_data *mdata);
+bool modem_at_idle(struct sim800l_data *mdata);
+int modem_at_send(struct sim800l_data *mdata, enum modem_at_class cls,
+		  const struct modem_cmd *cmds, size_t cmds_len, const uint8_t *buf,
+		  k_timeout_t timeout);
+int modem_at_exec(struct sim800l_data *mdata, const struct modem_cmd *cmds, size_t cmds_len,
+		  const uint8_t *buf);
+int modem_at_cmd(struct sim800l_data *mdata, enum modem_at_class cls, const struct modem_cmd *cmds,
+		 size_t cmds_len, const uint8_t *buf);
+void modem_rtt_init(struct sim800l_data *mdata);
+k_timeout_t modem_rtt_timeout(struct sim800l_data *mdata, enum modem_rtt_class cls);
+void modem_rtt_sample(struct sim800l_data *mdata, enum modem_rtt_class cls, int64_t start);
+void modem_rtt_backoff(struct sim800l_data *mdata, enum modem_rtt_class cls);
+int modem_pdp_activate(struct sim800l_data *mdata);
+int modem_pdp_deactivate(struct sim800l_data *mdata);
+int modem_bring_up(struct sim800l_data *mdata);
+int modem_reboot(struct sim800l_data *mdata);
+void modem_link_init(struct sim800l_data *mdata);
+void modem_link_update(struct sim800l_data *mdata);
+void modem_conn_link_changed(struct sim800l_data *mdata, bool up);
 void modem_net_iface_init(struct net_if *iface);
-void modem_query_rssi(void);
+void modem_query_rssi(struct sim800l_data *mdata, enum modem_at_class cls);
+int modem_query_registration(struct sim800l_data *mdata, enum modem_at_class cls);
+int modem_query_attach(struct sim800l_data *mdata, enum modem_at_class cls);
+void modem_operator_hint(struct sim800l_data *mdata);
+void modem_operator_update(struct sim800l_data *mdata);
+void modem_monitor_init(struct sim800l_data *mdata);
+void modem_monitor_start(struct sim800l_data *mdata);
+void modem_monitor_stop(struct sim800l_data *mdata);
+void modem_capture_init(struct sim800l_data *mdata);
+void modem_lazy_init(struct sim800l_data *mdata);
+int modem_lazy_get(struct sim800l_data *mdata);
+void modem_lazy_put(struct sim800l_data *mdata);
+int modem_sleep_init(struct sim800l_data *mdata);
+int modem_sleep_start(struct sim800l_data *mdata);
+void modem_sleep_stop(struct sim800l_data *mdata);
+void modem_sleep_wake(struct sim800l_data *mdata);
+void modem_sleep_idle(struct sim800l_data *mdata);
+int modem_sleep_suspend(struct sim800l_data *mdata);
+int modem_sleep_resume(struct sim800l_data *mdata);
+void modem_time_init(struct sim800l_data *mdata);
+void modem_time_network(struct sim800l_data *mdata, char **argv, uint16_t argc);
+void modem_time_query(struct sim800l_data *mdata);
+void modem_settings_load(struct sim800l_data *mdata);
+void modem_settings_save(struct sim800l_data *mdata, const char *name);
+void modem_settings_save_identity(struct sim800l_data *mdata);
+void modem_settings_save_network(struct sim800l_data *mdata);
+void modem_health_init(struct sim800l_data *mdata);
+void modem_health_start(struct sim800l_data *mdata);
+void modem_health_stop(struct sim800l_data *mdata);
+void modem_health_timeout(struct sim800l_data *mdata);
+void modem_health_answer(struct sim800l_data *mdata);
+size_t modem_read_payload(struct sim800l_data *mdata, int sock_id, uint8_t *dst, size_t room,
+			  int data_len);
+int modem_bearer_open(struct sim800l_data *mdata);
+void modem_ftp_init(struct sim800l_data *mdata);
+void modem_ftp_urc(struct sim800l_data *mdata, int code);
+void modem_http_init(struct sim800l_data *mdata);
+void modem_http_action(struct sim800l_data *mdata, int status, size_t len);
 
-bool modem_offload_is_supported(int family, int type, int proto);
-int modem_offload_socket(int family, int type, int proto);
+int modem_offload_socket(struct sim800l_data *mdata, int family, int type, int proto);
+void modem_keepalive_default(struct sim800l_keepalive *ka);
+void modem_links_init(struct sim800l_data *mdata);
+void modem_links_reset(struct sim800l_data *mdata);
+void modem_server_init(struct sim800l_data *mdata);
+void modem_server_incoming(struct sim800l_data *mdata, int link, const char *ip);
+void modem_socket_peer_closed(struct sim800l_data *mdata, int link);
+void modem_socket_rx_lost(struct sim800l_data *mdata, int link);
+void modem_urc_init(struct sim800l_data *mdata, k_thread_stack_t *stack, size_t stack_size);
+void modem_urc_data(struct sim800l_data *mdata, int link, struct net_buf *buf);
+void modem_urc_lost(struct sim800l_data *mdata, int link);
+void modem_urc_closed(struct sim800l_data *mdata, int link);
+void modem_urc_remote_ip(struct sim800l_data *mdata, int link, const char *ip);
+void modem_socket_result(struct sim800l_data *mdata, int link, const char *status);
 
-extern struct sim800l_data mdata;
 extern const struct socket_op_vtable offload_socket_fd_op_vtable;
+extern const struct cellular_driver_api sim800l_cellular_api;
+#ifdef CONFIG_MODEM_SIM800L_CONN_MGR
+CONN_MGR_CONN_DECLARE_PUBLIC(SIM800L_CONN);
+#endif
 #endif /* SIMCOM_SIM800L_H */
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * AT channel arbiter.
+ *
+ * The modem answers one command at a time and the command handler has a
+ * single response semaphore, so every exchange owns the channel from the
+ * command to its final result code. Waiting requests are queued per class
+ * and a released channel goes to the oldest request of the highest class:
+ * socket data first, then control commands, then the status monitor.
+ *
+ * The deadline given to a request bounds the wait for the channel. Once a
+ * command is on the wire it gets its full response timeout, giving up
+ * earlier would leave a late result code for the next owner to consume.
+ *
+ * The owner may acquire the channel again, so a sequence like the boot
+ * holds it across the commands it sends through the helpers below.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/slist.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_at, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* A request queued for the channel, lives on the caller's stack */
+struct at_waiter {
+	sys_snode_t node;
+	struct k_sem granted;
+	k_tid_t thread;
+};
+
+static int at_acquire(struct sim800l_data *mdata, enum modem_at_class cls, k_timepoint_t deadline)
+{
+	struct at_waiter waiter;
+	k_spinlock_key_t key;
+	bool queued;
+
+	key = k_spin_lock(&mdata->at.lock);
+
+	if (!mdata->at.busy) {
+		mdata->at.busy = true;
+		mdata->at.owner = k_current_get();
+		mdata->at.depth = 0;
+		k_spin_unlock(&mdata->at.lock, key);
+		return 0;
+	}
+
+	if (mdata->at.owner == k_current_get()) {
+		mdata->at.depth++;
+		k_spin_unlock(&mdata->at.lock, key);
+		return 0;
+	}
+
+	if (sys_timepoint_expired(deadline)) {
+		k_spin_unlock(&mdata->at.lock, key);
+		return -EAGAIN;
+	}
+
+	k_sem_init(&waiter.granted, 0, 1);
+	waiter.thread = k_current_get();
+	sys_slist_append(&mdata->at.waiters[cls], &waiter.node);
+	k_spin_unlock(&mdata->at.lock, key);
+
+	if (k_sem_take(&waiter.granted, sys_timepoint_timeout(deadline)) == 0) {
+		return 0;
+	}
+
+	/* Still queued means nobody handed over the channel in the meantime */
+	key = k_spin_lock(&mdata->at.lock);
+	queued = sys_slist_find_and_remove(&mdata->at.waiters[cls], &waiter.node);
+	k_spin_unlock(&mdata->at.lock, key);
+
+	if (queued) {
+		LOG_DBG("AT channel busy, class %d gave up", cls);
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+int modem_at_acquire(struct sim800l_data *mdata, enum modem_at_class cls, k_timepoint_t deadline)
+{
+	int ret;
+
+	ret = at_acquire(mdata, cls, deadline);
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	if (ret == 0) {
+		modem_sleep_wake(mdata);
+	}
+#endif
+
+	return ret;
+}
+
+void modem_at_release(struct sim800l_data *mdata)
+{
+	struct at_waiter *waiter;
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	key = k_spin_lock(&mdata->at.lock);
+
+	if (mdata->at.depth > 0) {
+		mdata->at.depth--;
+		k_spin_unlock(&mdata->at.lock, key);
+		return;
+	}
+
+	for (int i = 0; i < MDM_AT_CLASSES; i++) {
+		node = sys_slist_get(&mdata->at.waiters[i]);
+		if (node) {
+			/* The channel stays busy, ownership moves to the waiter */
+			waiter = CONTAINER_OF(node, struct at_waiter, node);
+			mdata->at.owner = waiter->thread;
+			k_sem_give(&waiter->granted);
+			k_spin_unlock(&mdata->at.lock, key);
+			return;
+		}
+	}
+
+	mdata->at.busy = false;
+	mdata->at.owner = NULL;
+	k_spin_unlock(&mdata->at.lock, key);
+
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	modem_sleep_idle(mdata);
+#endif
+}
+
+bool modem_at_idle(struct sim800l_data *mdata)
+{
+	return !mdata->at.busy;
+}
+
+int modem_at_send(struct sim800l_data *mdata, enum modem_at_class cls,
+		  const struct modem_cmd *cmds, size_t cmds_len, const uint8_t *buf,
+		  k_timeout_t timeout)
+{
+	int ret;
+
+	ret = modem_at_acquire(mdata, cls, sys_timepoint_calc(timeout));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = modem_cmd_send(&mdata->ctx.iface, &mdata->ctx.cmd_handler, cmds, cmds_len, buf,
+			     &mdata->sem_response, timeout);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	if (ret == -ETIMEDOUT) {
+		modem_health_timeout(mdata);
+	} else if (ret == 0 || ret == -EIO) {
+		modem_health_answer(mdata);
+	}
+#endif
+
+	modem_at_release(mdata);
+	return ret;
+}
+
+/*
+ * Send a quick command with the channel already held. The response timeout
+ * follows the measured response times.
+ */
+int modem_at_exec(struct sim800l_data *mdata, const struct modem_cmd *cmds, size_t cmds_len,
+		  const uint8_t *buf)
+{
+	int64_t start = k_uptime_get();
+	int ret;
+
+	ret = modem_cmd_send(&mdata->ctx.iface, &mdata->ctx.cmd_handler, cmds, cmds_len, buf,
+			     &mdata->sem_response, modem_rtt_timeout(mdata, MDM_RTT_CMD));
+	if (ret == -ETIMEDOUT) {
+		modem_rtt_backoff(mdata, MDM_RTT_CMD);
+	} else if (ret == 0 || ret == -EIO) {
+		modem_rtt_sample(mdata, MDM_RTT_CMD, start);
+	}
+
+	return ret;
+}
+
+/* modem_at_send() for a quick command, with the adaptive timeout */
+int modem_at_cmd(struct sim800l_data *mdata, enum modem_at_class cls, const struct modem_cmd *cmds,
+		 size_t cmds_len, const uint8_t *buf)
+{
+	int ret;
+
+	ret = modem_at_acquire(mdata, cls, sys_timepoint_calc(MDM_CMD_TIMEOUT));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = modem_at_exec(mdata, cmds, cmds_len, buf);
+
+	modem_at_release(mdata);
+	return ret;
+}
+
+void modem_at_init(struct sim800l_data *mdata)
+{
+	mdata->at.busy = false;
+	mdata->at.owner = NULL;
+	mdata->at.depth = 0;
+
+	for (int i = 0; i < MDM_AT_CLASSES; i++) {
+		sys_slist_init(&mdata->at.waiters[i]);
+	}
+}
@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Raw UART traffic capture.
+ *
+ * The read and write functions of the modem interface are wrapped, so the
+ * bytes passed between the UART interface and the command handler are
+ * recorded. Every record holds the uptime in microseconds, the direction
+ * and up to CAPTURE_CHUNK bytes and is kept in a ring buffer, the oldest
+ * records are dropped when it is full.
+ *
+ * "sim800l capture dump" prints and removes the records, one per line in
+ * the format tests/modem-replay feeds back into the driver:
+ *
+ *   <uptime us> RX|TX <hex>
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/sys/util.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_capture, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Longest record, longer blocks are split and keep their timestamp */
+#define CAPTURE_CHUNK 64
+
+enum capture_dir {
+	CAPTURE_RX,
+	CAPTURE_TX,
+};
+
+struct capture_hdr {
+	uint32_t time_us;
+	uint8_t dir;
+	uint8_t len;
+} __packed;
+
+/* Modems with a capture, looked up by the shell */
+static struct sim800l_data *capture_modems[MDM_MAX_INSTANCES];
+
+/* Drop the oldest records until need bytes fit, called with the lock held */
+static void capture_make_room(struct sim800l_data *mdata, uint32_t need)
+{
+	struct capture_hdr hdr;
+
+	while (ring_buf_space_get(&mdata->capture.rb) < need) {
+		if (ring_buf_get(&mdata->capture.rb, (uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr)) {
+			ring_buf_reset(&mdata->capture.rb);
+			return;
+		}
+
+		ring_buf_get(&mdata->capture.rb, NULL, hdr.len);
+		mdata->capture.dropped++;
+	}
+}
+
+static void capture_record(struct sim800l_data *mdata, enum capture_dir dir, const uint8_t *buf,
+			   size_t len)
+{
+	struct capture_hdr hdr = {
+		.time_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks()),
+		.dir = dir,
+	};
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&mdata->capture.lock);
+
+	while (len > 0) {
+		hdr.len = MIN(len, CAPTURE_CHUNK);
+		capture_make_room(mdata, sizeof(hdr) + hdr.len);
+		ring_buf_put(&mdata->capture.rb, (uint8_t *)&hdr, sizeof(hdr));
+		ring_buf_put(&mdata->capture.rb, buf, hdr.len);
+
+		buf += hdr.len;
+		len -= hdr.len;
+	}
+
+	k_spin_unlock(&mdata->capture.lock, key);
+}
+
+static int capture_read(struct modem_iface *iface, uint8_t *buf, size_t size,
+			size_t *bytes_read)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(iface, struct sim800l_data, ctx.iface);
+	int ret;
+
+	ret = mdata->capture.read(iface, buf, size, bytes_read);
+	if (ret == 0 && *bytes_read > 0) {
+		capture_record(mdata, CAPTURE_RX, buf, *bytes_read);
+	}
+
+	return ret;
+}
+
+/* Recorded before it is written, so a fast answer never comes first */
+static int capture_write(struct modem_iface *iface, const uint8_t *buf, size_t size)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(iface, struct sim800l_data, ctx.iface);
+
+	capture_record(mdata, CAPTURE_TX, buf, size);
+
+	return mdata->capture.write(iface, buf, size);
+}
+
+/* Wrap the interface set up by modem_iface_uart_init() */
+void modem_capture_init(struct sim800l_data *mdata)
+{
+	ring_buf_init(&mdata->capture.rb, sizeof(mdata->capture.buf), mdata->capture.buf);
+	mdata->capture.dropped = 0;
+
+	mdata->capture.read = mdata->ctx.iface.read;
+	mdata->capture.write = mdata->ctx.iface.write;
+	mdata->ctx.iface.read = capture_read;
+	mdata->ctx.iface.write = capture_write;
+
+	for (int i = 0; i < ARRAY_SIZE(capture_modems); i++) {
+		if (!capture_modems[i]) {
+			capture_modems[i] = mdata;
+			break;
+		}
+	}
+
+	LOG_DBG("Capturing UART traffic of %s", mdata->dev->name);
+}
+
+#ifdef CONFIG_SHELL
+static struct sim800l_data *capture_modem(const struct shell *sh, size_t argc, char **argv)
+{
+	for (int i = 0; i < ARRAY_SIZE(capture_modems); i++) {
+		if (capture_modems[i] &&
+		    (argc < 2 || strcmp(capture_modems[i]->dev->name, argv[1]) == 0)) {
+			return capture_modems[i];
+		}
+	}
+
+	shell_error(sh, "No capture on %s", argc < 2 ? "any modem" : argv[1]);
+	return NULL;
+}
+
+static int cmd_capture_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	struct sim800l_data *mdata = capture_modem(sh, argc, argv);
+	uint8_t data[CAPTURE_CHUNK];
+	char hex[CAPTURE_CHUNK * 2 + 1];
+	struct capture_hdr hdr;
+	k_spinlock_key_t key;
+	uint32_t dropped;
+	uint32_t got;
+
+	if (!mdata) {
+		return -ENODEV;
+	}
+
+	key = k_spin_lock(&mdata->capture.lock);
+	dropped = mdata->capture.dropped;
+	mdata->capture.dropped = 0;
+	k_spin_unlock(&mdata->capture.lock, key);
+
+	shell_print(sh, "# sim800l capture %s, %u records dropped", mdata->dev->name, dropped);
+
+	/* One record at a time, the lock is not held while printing */
+	while (true) {
+		key = k_spin_lock(&mdata->capture.lock);
+		got = 0;
+		if (ring_buf_get(&mdata->capture.rb, (uint8_t *)&hdr, sizeof(hdr)) == sizeof(hdr)) {
+			got = ring_buf_get(&mdata->capture.rb, data, hdr.len);
+		}
+		k_spin_unlock(&mdata->capture.lock, key);
+
+		if (got == 0) {
+			break;
+		}
+
+		bin2hex(data, got, hex, sizeof(hex));
+		shell_print(sh, "%u %s %s", hdr.time_us, hdr.dir == CAPTURE_TX ? "TX" : "RX", hex);
+	}
+
+	return 0;
+}
+
+static int cmd_capture_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	struct sim800l_data *mdata = capture_modem(sh, argc, argv);
+	k_spinlock_key_t key;
+
+	if (!mdata) {
+		return -ENODEV;
+	}
+
+	key = k_spin_lock(&mdata->capture.lock);
+	ring_buf_reset(&mdata->capture.rb);
+	mdata->capture.dropped = 0;
+	k_spin_unlock(&mdata->capture.lock, key);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_capture,
+	SHELL_CMD_ARG(dump, NULL, "Print and remove the captured records [device]",
+		      cmd_capture_dump, 1, 1),
+	SHELL_CMD_ARG(clear, NULL, "Drop the captured records [device]", cmd_capture_clear, 1, 1),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_sim800l,
+	SHELL_CMD(capture, &sub_capture, "Raw UART traffic capture", NULL),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(sim800l, &sub_sim800l, "SIM800L modem commands", NULL);
+#endif /* CONFIG_SHELL */
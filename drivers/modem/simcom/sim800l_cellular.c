@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Generic cellular API.
+ *
+ * Every call is answered from the driver data: the identity is read once
+ * during boot, registration follows the +CREG URC and the signal is kept
+ * current by the network status monitor. Nothing here touches the AT
+ * channel.
+ */
+
+#include <string.h>
+
+#include <zephyr/drivers/cellular.h>
+#include <zephyr/logging/log.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_cellular, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+static int modem_cellular_get_signal(const struct device *dev, const enum cellular_signal_type type,
+				     int16_t *value)
+{
+	struct sim800l_data *mdata = dev->data;
+
+	/* 2G only reports RSSI */
+	if (type != CELLULAR_SIGNAL_RSSI) {
+		return -ENOTSUP;
+	}
+
+	if (mdata->rssi <= -1000) {
+		return -ENODATA;
+	}
+
+	*value = mdata->rssi;
+	return 0;
+}
+
+static int modem_cellular_get_modem_info(const struct device *dev,
+					 const enum cellular_modem_info_type type, char *info,
+					 size_t size)
+{
+	struct sim800l_data *mdata = dev->data;
+	const char *src;
+
+	switch (type) {
+	case CELLULAR_MODEM_INFO_IMEI:
+		src = mdata->imei;
+		break;
+	case CELLULAR_MODEM_INFO_MODEL_ID:
+		src = mdata->model;
+		break;
+	case CELLULAR_MODEM_INFO_MANUFACTURER:
+		src = mdata->manufacturer;
+		break;
+	case CELLULAR_MODEM_INFO_FW_VERSION:
+		src = mdata->revision;
+		break;
+	case CELLULAR_MODEM_INFO_SIM_IMSI:
+		src = mdata->imsi;
+		break;
+	case CELLULAR_MODEM_INFO_SIM_ICCID:
+		src = mdata->iccid;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	if (src[0] == '\0') {
+		return -ENODATA;
+	}
+
+	if (size == 0) {
+		return -ENOMEM;
+	}
+
+	strncpy(info, src, size - 1);
+	info[size - 1] = '\0';
+	return 0;
+}
+
+static int modem_cellular_get_registration_status(const struct device *dev,
+						  enum cellular_access_technology tech,
+						  enum cellular_registration_status *status)
+{
+	struct sim800l_data *mdata = dev->data;
+
+	if (tech != CELLULAR_ACCESS_TECHNOLOGY_GSM && tech != CELLULAR_ACCESS_TECHNOLOGY_GPRS) {
+		return -ENOTSUP;
+	}
+
+	/* The +CREG <stat> values match the enum */
+	if (mdata->network_registration > CELLULAR_REGISTRATION_REGISTERED_ROAMING) {
+		*status = CELLULAR_REGISTRATION_UNKNOWN;
+	} else {
+		*status = mdata->network_registration;
+	}
+
+	return 0;
+}
+
+const struct cellular_driver_api sim800l_cellular_api = {
+	.get_signal = modem_cellular_get_signal,
+	.get_modem_info = modem_cellular_get_modem_info,
+	.get_registration_status = modem_cellular_get_registration_status,
+};
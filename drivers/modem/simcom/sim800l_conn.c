@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Connection manager binding.
+ *
+ * conn_mgr_if_connect() brings the modem and the PDP context up from the
+ * control work queue, retrying until the binding timeout expires.
+ * conn_mgr_if_disconnect() shuts the context down with AT+CIPSHUT from the
+ * same queue, after a bring-up in progress. The L4 events follow the
+ * interface state driven by modem_link_update().
+ */
+
+#include <zephyr/logging/log.h>
+#include <zephyr/net/conn_mgr_connectivity.h>
+#include <zephyr/net/conn_mgr_connectivity_impl.h>
+#include <zephyr/net/net_mgmt.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_conn, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Delay between bring-up attempts */
+#define CONN_RETRY_DELAY K_SECONDS(10)
+
+static void conn_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_data *mdata = CONTAINER_OF(dwork, struct sim800l_data, conn.work);
+	int ret;
+
+	if (!mdata->conn.requested) {
+		return;
+	}
+
+	ret = modem_bring_up(mdata);
+	if (ret == 0) {
+		LOG_DBG("Modem connected");
+		return;
+	}
+
+	if (mdata->conn.deadline > 0 && k_uptime_get() >= mdata->conn.deadline) {
+		LOG_WRN("Connect timed out: %d", ret);
+		mdata->conn.requested = false;
+		net_mgmt_event_notify(NET_EVENT_CONN_IF_TIMEOUT, mdata->netif);
+		return;
+	}
+
+	LOG_DBG("Connect failed: %d, retrying", ret);
+	k_work_reschedule_for_queue(&mdata->ctl_workq, dwork, CONN_RETRY_DELAY);
+}
+
+static void conn_shutdown_work(struct k_work *work)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(work, struct sim800l_data, conn.shutdown_work);
+
+	/* Connected again in the meantime */
+	if (mdata->conn.requested ||
+	    (mdata->status_flags & SIM800L_STATUS_FLAG_PDP_ACTIVE) == 0) {
+		return;
+	}
+
+	modem_pdp_deactivate(mdata);
+}
+
+/* Called from the link work when the interface goes up or down */
+void modem_conn_link_changed(struct sim800l_data *mdata, bool up)
+{
+	if (up || !mdata->conn.requested) {
+		return;
+	}
+
+	if (conn_mgr_binding_get_flag(mdata->conn.binding, CONN_MGR_IF_PERSISTENT)) {
+		LOG_INF("Link lost, reconnecting");
+		mdata->conn.deadline = 0;
+		k_work_reschedule_for_queue(&mdata->ctl_workq, &mdata->conn.work,
+					    CONN_RETRY_DELAY);
+	} else {
+		mdata->conn.requested = false;
+	}
+}
+
+static int conn_connect(struct conn_mgr_conn_binding *const binding)
+{
+	struct sim800l_data *mdata = binding->ctx;
+
+	mdata->conn.requested = true;
+	mdata->conn.deadline = 0;
+	if (binding->timeout > 0) {
+		mdata->conn.deadline = k_uptime_get() + (int64_t)binding->timeout * MSEC_PER_SEC;
+	}
+
+	k_work_reschedule_for_queue(&mdata->ctl_workq, &mdata->conn.work, K_NO_WAIT);
+	return 0;
+}
+
+static int conn_disconnect(struct conn_mgr_conn_binding *const binding)
+{
+	struct sim800l_data *mdata = binding->ctx;
+
+	mdata->conn.requested = false;
+	k_work_cancel_delayable(&mdata->conn.work);
+	k_work_submit_to_queue(&mdata->ctl_workq, &mdata->conn.shutdown_work);
+
+	return 0;
+}
+
+static void conn_init(struct conn_mgr_conn_binding *const binding)
+{
+	struct sim800l_data *mdata = binding->ctx;
+
+	mdata->conn.binding = binding;
+	k_work_init_delayable(&mdata->conn.work, conn_work);
+	k_work_init(&mdata->conn.shutdown_work, conn_shutdown_work);
+}
+
+static struct conn_mgr_conn_api sim800l_conn_api = {
+	.connect = conn_connect,
+	.disconnect = conn_disconnect,
+	.init = conn_init,
+};
+
+CONN_MGR_CONN_DEFINE(SIM800L_CONN, &sim800l_conn_api);
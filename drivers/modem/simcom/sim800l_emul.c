@@ -0,0 +1,1144 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem emulator
+ *
+ * Scripted responder for the AT dialect used by the SIM800L driver. It sits
+ * on the other side of a zephyr,uart-emul device so the driver can be run
+ * and benchmarked on native_sim without hardware or a live server.
+ */
+
+#define DT_DRV_COMPAT simcom_sim800l_emul
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#ifdef CONFIG_GPIO_EMUL
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#endif
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_emul, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+#define EMUL_MAX_LINKS       5
+#define EMUL_LINE_MAX        256
+#define EMUL_CMD_QUEUE_LEN   4
+#define EMUL_MAX_ARGS        6
+#define EMUL_MAX_SEND        1460
+#define EMUL_MAX_RECEIVE     1024
+#define EMUL_LINK_RB_SIZE    4096
+#define EMUL_RESET_POLL      K_MSEC(20)
+#define EMUL_BOOT_STEP       K_MSEC(200)
+
+#define EMUL_PORT_DISCARD 9
+#define EMUL_PORT_SOURCE  19
+
+enum emul_boot_stage {
+	EMUL_BOOT_OFF = 0,
+	EMUL_BOOT_PENDING,
+	EMUL_BOOT_RDY,
+	EMUL_BOOT_CPIN,
+	EMUL_BOOT_DONE,
+};
+
+struct sim800l_emul_data;
+
+struct sim800l_emul_link {
+	struct sim800l_emul_data *emul;
+	struct k_work_delayable connect_work;
+	struct k_work_delayable rx_work;
+	uint8_t id;
+	bool connected;
+	/* UDP payload is queued as length prefixed datagrams */
+	bool udp;
+	char addr[16];
+	uint16_t port;
+	/* Bytes still to be produced by the source service */
+	size_t source_left;
+	struct ring_buf rx_rb;
+	uint8_t rx_rb_buf[EMUL_LINK_RB_SIZE];
+};
+
+struct sim800l_emul_data {
+	const struct device *dev;
+	struct k_work tx_work;
+	struct k_work_delayable cmd_work;
+	struct k_work_delayable boot_work;
+	struct k_work_delayable send_work;
+	struct k_work_delayable dns_work;
+	struct k_work_delayable ftp_work;
+	struct k_work_delayable http_work;
+	struct k_work_delayable reset_work;
+
+	enum emul_boot_stage boot;
+	bool echo;
+	/* AT+CIPSRIP=1, prefix payload with the sender */
+	bool srip;
+	int reset_level;
+
+	/* Command line being assembled */
+	char line[EMUL_LINE_MAX];
+	size_t line_len;
+
+	/* Data mode after the CIPSEND prompt */
+	struct sim800l_emul_link *send_link;
+	size_t send_left;
+	size_t send_len;
+	uint8_t send_buf[EMUL_MAX_SEND];
+
+	char dns_name[EMUL_LINE_MAX];
+
+	/* FTP file, its name is the size in bytes like the source service */
+	size_t ftp_size;
+	size_t ftp_rest;
+	size_t ftp_left;
+
+	/*
+	 * HTTP: POST echoes the body, GET returns as many bytes as the last
+	 * URL path component says.
+	 */
+	bool http_data;
+	int http_method;
+	size_t http_get_size;
+	size_t http_len;
+	uint8_t http_body[EMUL_MAX_SEND];
+
+	struct sim800l_emul_link links[EMUL_MAX_LINKS];
+};
+
+struct sim800l_emul_config {
+	const struct device *uart;
+	struct gpio_dt_spec reset_gpio;
+	struct k_msgq *cmd_msgq;
+	uint32_t response_latency_ms;
+	uint32_t network_latency_ms;
+	uint32_t bandwidth_bps;
+	uint32_t boot_delay_ms;
+	uint8_t rssi;
+};
+
+struct emul_cmd {
+	const char *prefix;
+	void (*handler)(const struct device *dev, char *args);
+};
+
+static K_THREAD_STACK_DEFINE(emul_stack, 2048);
+static struct k_work_q emul_work_q;
+static bool emul_work_q_started;
+
+/* Time in microseconds the link needs to carry len bytes */
+static uint64_t emul_airtime_us(const struct sim800l_emul_config *cfg, size_t len)
+{
+	if (cfg->bandwidth_bps == 0U) {
+		return 0;
+	}
+
+	return (uint64_t)len * 8U * USEC_PER_SEC / cfg->bandwidth_bps;
+}
+
+static k_timeout_t emul_delay(const struct sim800l_emul_config *cfg, uint32_t ms, size_t len)
+{
+	return K_USEC((uint64_t)ms * USEC_PER_MSEC + emul_airtime_us(cfg, len));
+}
+
+static void emul_write(const struct device *dev, const void *buf, size_t len)
+{
+	const struct sim800l_emul_config *cfg = dev->config;
+	uint32_t put;
+
+	put = uart_emul_put_rx_data(cfg->uart, buf, len);
+	if (put < len) {
+		LOG_WRN("UART RX fifo full, dropped %zu bytes", len - put);
+	}
+}
+
+static void emul_line(const struct device *dev, const char *fmt, ...)
+{
+	char buf[EMUL_LINE_MAX + 4];
+	va_list args;
+	int len;
+
+	buf[0] = '\r';
+	buf[1] = '\n';
+
+	va_start(args, fmt);
+	len = vsnprintk(buf + 2, sizeof(buf) - 4, fmt, args);
+	va_end(args);
+
+	len = MIN(len, (int)sizeof(buf) - 5);
+	buf[len + 2] = '\r';
+	buf[len + 3] = '\n';
+
+	emul_write(dev, buf, len + 4);
+}
+
+static void emul_ok(const struct device *dev)
+{
+	emul_line(dev, "OK");
+}
+
+static void emul_error(const struct device *dev)
+{
+	emul_line(dev, "ERROR");
+}
+
+/*
+ * Splits comma separated arguments in place and strips the quotes.
+ */
+static int emul_parse_args(char *args, char **argv, int max)
+{
+	int argc = 0;
+
+	while (args && *args && argc < max) {
+		char *next = strchr(args, ',');
+
+		if (next) {
+			*next++ = '\0';
+		}
+
+		if (*args == '"') {
+			char *end = strchr(++args, '"');
+
+			if (end) {
+				*end = '\0';
+			}
+		}
+
+		argv[argc++] = args;
+		args = next;
+	}
+
+	return argc;
+}
+
+static struct sim800l_emul_link *emul_link_get(const struct device *dev, const char *id)
+{
+	struct sim800l_emul_data *data = dev->data;
+	int n = atoi(id);
+
+	if (n < 0 || n >= EMUL_MAX_LINKS) {
+		return NULL;
+	}
+
+	return &data->links[n];
+}
+
+static void emul_link_reset(struct sim800l_emul_link *link)
+{
+	k_work_cancel_delayable(&link->connect_work);
+	k_work_cancel_delayable(&link->rx_work);
+	ring_buf_reset(&link->rx_rb);
+	link->connected = false;
+	link->udp = false;
+	link->source_left = 0;
+	link->port = 0;
+}
+
+/*
+ * Delivers queued payload to the driver as +RECEIVE URCs, paced by the
+ * configured bandwidth.
+ */
+static void emul_link_rx_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_link *link = CONTAINER_OF(dwork, struct sim800l_emul_link, rx_work);
+	const struct device *dev = link->emul->dev;
+	const struct sim800l_emul_config *cfg = dev->config;
+	uint8_t payload[EMUL_MAX_RECEIVE];
+	char header[64];
+	uint16_t dgram_len;
+	size_t len;
+
+	if (!link->connected) {
+		return;
+	}
+
+	if (link->udp && ring_buf_get(&link->rx_rb, (uint8_t *)&dgram_len, sizeof(dgram_len))) {
+		len = ring_buf_get(&link->rx_rb, payload, dgram_len);
+	} else {
+		len = ring_buf_get(&link->rx_rb, payload, sizeof(payload));
+	}
+
+	if (len == 0 && link->source_left > 0) {
+		len = MIN(link->source_left, sizeof(payload));
+		for (size_t i = 0; i < len; i++) {
+			payload[i] = 'A' + (i % 26);
+		}
+		link->source_left -= len;
+	}
+
+	if (len == 0) {
+		return;
+	}
+
+	if (link->emul->srip) {
+		snprintk(header, sizeof(header), "\r\nRECV FROM:%s:%u", link->addr, link->port);
+		emul_write(dev, header, strlen(header));
+	}
+
+	snprintk(header, sizeof(header), "\r\n+RECEIVE,%u,%zu:\r\n", link->id, len);
+	emul_write(dev, header, strlen(header));
+	emul_write(dev, payload, len);
+
+	/* The next chunk is due once this one has crossed the link */
+	if (!ring_buf_is_empty(&link->rx_rb) || link->source_left > 0) {
+		k_work_reschedule_for_queue(&emul_work_q, &link->rx_work,
+					    K_USEC(emul_airtime_us(cfg, len)));
+	}
+}
+
+static void emul_link_connect_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_link *link =
+		CONTAINER_OF(dwork, struct sim800l_emul_link, connect_work);
+
+	link->connected = true;
+	emul_line(link->emul->dev, "%u, CONNECT OK", link->id);
+}
+
+/*
+ * Hands a completed CIPSEND payload to the loopback peer of the link.
+ */
+static void emul_link_serve(const struct device *dev, struct sim800l_emul_link *link,
+			    const uint8_t *buf, size_t len)
+{
+	const struct sim800l_emul_config *cfg = dev->config;
+	char count[12];
+
+	switch (link->port) {
+	case EMUL_PORT_DISCARD:
+		return;
+	case EMUL_PORT_SOURCE:
+		memcpy(count, buf, MIN(len, sizeof(count) - 1));
+		count[MIN(len, sizeof(count) - 1)] = '\0';
+		link->source_left += strtoul(count, NULL, 10);
+		break;
+	default:
+		if (link->udp) {
+			uint16_t dgram_len = len;
+
+			/* Datagrams are echoed whole or not at all */
+			if (ring_buf_space_get(&link->rx_rb) < sizeof(dgram_len) + len) {
+				LOG_WRN("Link %u echo buffer full", link->id);
+				return;
+			}
+
+			ring_buf_put(&link->rx_rb, (uint8_t *)&dgram_len, sizeof(dgram_len));
+		}
+
+		if (ring_buf_put(&link->rx_rb, buf, len) < len) {
+			LOG_WRN("Link %u echo buffer full", link->id);
+		}
+		break;
+	}
+
+	if (!k_work_delayable_is_pending(&link->rx_work)) {
+		k_work_schedule_for_queue(&emul_work_q, &link->rx_work,
+					  emul_delay(cfg, cfg->network_latency_ms, len));
+	}
+}
+
+static void emul_send_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, send_work);
+	struct sim800l_emul_link *link = data->send_link;
+
+	data->send_link = NULL;
+	if (!link) {
+		/* AT+HTTPDATA body */
+		if (data->http_data) {
+			data->http_data = false;
+			memcpy(data->http_body, data->send_buf, data->send_len);
+			data->http_len = data->send_len;
+			emul_ok(data->dev);
+		}
+		return;
+	}
+
+	if (!link->connected) {
+		emul_line(data->dev, "%u, SEND FAIL", link->id);
+		return;
+	}
+
+	emul_line(data->dev, "%u, SEND OK", link->id);
+	emul_link_serve(data->dev, link, data->send_buf, data->send_len);
+}
+
+static void emul_dns_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, dns_work);
+
+	emul_line(data->dev, "+CDNSGIP: 1,\"%s\",\"127.0.0.1\"", data->dns_name);
+}
+
+static void emul_http_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, http_work);
+
+	if (data->http_method != 1) {
+		data->http_len = MIN(data->http_get_size, sizeof(data->http_body));
+		for (size_t i = 0; i < data->http_len; i++) {
+			data->http_body[i] = 'A' + (i % 26);
+		}
+	}
+
+	emul_line(data->dev, "+HTTPACTION: %d,200,%zu", data->http_method,
+		  data->http_method == 2 ? 0 : data->http_len);
+}
+
+/* Reports the FTP session state: data available or transfer finished */
+static void emul_ftp_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, ftp_work);
+
+	emul_line(data->dev, "+FTPGET: 1,%d", data->ftp_left > 0 ? 1 : 0);
+}
+
+static void emul_boot_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, boot_work);
+
+	switch (data->boot) {
+	case EMUL_BOOT_PENDING:
+		emul_line(data->dev, "RDY");
+		data->boot = EMUL_BOOT_RDY;
+		break;
+	case EMUL_BOOT_RDY:
+		emul_line(data->dev, "+CFUN: 1");
+		emul_line(data->dev, "+CPIN: READY");
+		data->boot = EMUL_BOOT_CPIN;
+		break;
+	case EMUL_BOOT_CPIN:
+		emul_line(data->dev, "Call Ready");
+		emul_line(data->dev, "SMS Ready");
+		data->boot = EMUL_BOOT_DONE;
+		return;
+	default:
+		return;
+	}
+
+	k_work_schedule_for_queue(&emul_work_q, &data->boot_work, EMUL_BOOT_STEP);
+}
+
+static void emul_reset(const struct device *dev)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	LOG_DBG("Emulated modem reset");
+
+	k_work_cancel_delayable(&data->boot_work);
+	k_work_cancel_delayable(&data->send_work);
+	k_work_cancel_delayable(&data->dns_work);
+	k_work_cancel_delayable(&data->ftp_work);
+	k_work_cancel_delayable(&data->http_work);
+	data->http_data = false;
+	data->ftp_left = 0;
+
+	for (int i = 0; i < EMUL_MAX_LINKS; i++) {
+		emul_link_reset(&data->links[i]);
+	}
+
+	data->boot = EMUL_BOOT_OFF;
+	data->echo = true;
+	data->srip = false;
+	data->line_len = 0;
+	data->send_link = NULL;
+	data->send_left = 0;
+}
+
+#ifdef CONFIG_GPIO_EMUL
+/*
+ * The emulator has no view of the reset line other than the emulated GPIO,
+ * so it is polled for edges.
+ */
+static void emul_reset_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, reset_work);
+	const struct sim800l_emul_config *cfg = data->dev->config;
+	int level;
+
+	level = gpio_emul_output_get(cfg->reset_gpio.port, cfg->reset_gpio.pin);
+	if (level >= 0 && level != data->reset_level) {
+		data->reset_level = level;
+		emul_reset(data->dev);
+	}
+
+	k_work_schedule_for_queue(&emul_work_q, &data->reset_work, EMUL_RESET_POLL);
+}
+#endif /* CONFIG_GPIO_EMUL */
+
+static void emul_cmd_at(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	const struct sim800l_emul_config *cfg = dev->config;
+
+	ARG_UNUSED(args);
+
+	/* The first AT after a reset ends autobauding and starts the boot */
+	if (data->boot == EMUL_BOOT_OFF) {
+		data->boot = EMUL_BOOT_PENDING;
+		k_work_schedule_for_queue(&emul_work_q, &data->boot_work,
+					  K_MSEC(cfg->boot_delay_ms));
+	}
+
+	emul_ok(dev);
+}
+
+static void emul_cmd_echo_off(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	ARG_UNUSED(args);
+
+	data->echo = false;
+	emul_ok(dev);
+}
+
+static void emul_cmd_echo_on(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	ARG_UNUSED(args);
+
+	data->echo = true;
+	emul_ok(dev);
+}
+
+static void emul_cmd_cgmi(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "SIMCOM_Ltd");
+	emul_ok(dev);
+}
+
+static void emul_cmd_cgmm(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "SIMCOM_SIM800L");
+	emul_ok(dev);
+}
+
+static void emul_cmd_cgmr(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "Revision:1418B05SIM800L24");
+	emul_ok(dev);
+}
+
+static void emul_cmd_cgsn(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "8662620300%05u", (unsigned int)(uintptr_t)dev & 0xffffU);
+	emul_ok(dev);
+}
+
+static void emul_cmd_cimi(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "2400700%08u", (unsigned int)(uintptr_t)dev & 0xffffU);
+	emul_ok(dev);
+}
+
+static void emul_cmd_ccid(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "894607000000%07u", (unsigned int)(uintptr_t)dev & 0xffffU);
+	emul_ok(dev);
+}
+
+static void emul_cmd_csq(const struct device *dev, char *args)
+{
+	const struct sim800l_emul_config *cfg = dev->config;
+
+	ARG_UNUSED(args);
+
+	emul_line(dev, "+CSQ: %u,0", cfg->rssi);
+	emul_ok(dev);
+}
+
+static void emul_cmd_creg(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "+CREG: 0,1");
+	emul_ok(dev);
+}
+
+static void emul_cmd_cgatt(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "+CGATT: 1");
+	emul_ok(dev);
+}
+
+static void emul_cmd_cifsr(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	/* CIFSR answers with the bare address and no OK */
+	emul_line(dev, "10.0.0.2");
+}
+
+static void emul_cmd_ok(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_ok(dev);
+}
+
+/* AT+CIPSTART=<n>,"<TCP|UDP>","<address>",<port> */
+static void emul_cmd_cipstart(const struct device *dev, char *args)
+{
+	const struct sim800l_emul_config *cfg = dev->config;
+	struct sim800l_emul_link *link;
+	char *argv[EMUL_MAX_ARGS];
+	int argc;
+
+	argc = emul_parse_args(args, argv, ARRAY_SIZE(argv));
+	link = (argc == 4) ? emul_link_get(dev, argv[0]) : NULL;
+	if (!link) {
+		emul_error(dev);
+		return;
+	}
+
+	emul_ok(dev);
+
+	if (link->connected) {
+		emul_line(dev, "%u, ALREADY CONNECT", link->id);
+		return;
+	}
+
+	link->udp = strcmp(argv[1], "UDP") == 0;
+	strncpy(link->addr, argv[2], sizeof(link->addr) - 1);
+	link->addr[sizeof(link->addr) - 1] = '\0';
+	link->port = atoi(argv[3]);
+	k_work_schedule_for_queue(&emul_work_q, &link->connect_work,
+				  K_MSEC(2 * cfg->network_latency_ms));
+}
+
+/* AT+CIPSEND=<n>,<length> */
+static void emul_cmd_cipsend(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	struct sim800l_emul_link *link;
+	char *argv[EMUL_MAX_ARGS];
+	int argc;
+	size_t len;
+
+	argc = emul_parse_args(args, argv, ARRAY_SIZE(argv));
+	link = (argc == 2) ? emul_link_get(dev, argv[0]) : NULL;
+	len = (argc == 2) ? strtoul(argv[1], NULL, 10) : 0;
+	if (!link || !link->connected || len == 0 || len > sizeof(data->send_buf)) {
+		emul_error(dev);
+		return;
+	}
+
+	data->send_link = link;
+	data->send_left = len;
+	data->send_len = 0;
+
+	emul_write(dev, "\r\n> ", 4);
+}
+
+/* AT+CIPCLOSE=<n>[,<quick>] */
+static void emul_cmd_cipclose(const struct device *dev, char *args)
+{
+	struct sim800l_emul_link *link;
+	char *argv[EMUL_MAX_ARGS];
+	int argc;
+
+	argc = emul_parse_args(args, argv, ARRAY_SIZE(argv));
+	link = (argc >= 1) ? emul_link_get(dev, argv[0]) : NULL;
+	if (!link || !link->connected) {
+		emul_error(dev);
+		return;
+	}
+
+	emul_link_reset(link);
+	emul_line(dev, "%u, CLOSE OK", link->id);
+}
+
+static void emul_cmd_cipshut(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	ARG_UNUSED(args);
+
+	for (int i = 0; i < EMUL_MAX_LINKS; i++) {
+		emul_link_reset(&data->links[i]);
+	}
+
+	emul_line(dev, "SHUT OK");
+}
+
+/* AT+CIPSRIP=<mode> */
+static void emul_cmd_cipsrip(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	data->srip = atoi(args) == 1;
+	emul_ok(dev);
+}
+
+/* AT+CIPSERVER=<mode>[,<port>] */
+static void emul_cmd_cipserver(const struct device *dev, char *args)
+{
+	char *argv[EMUL_MAX_ARGS];
+	int argc;
+	int mode;
+
+	argc = emul_parse_args(args, argv, ARRAY_SIZE(argv));
+	mode = (argc >= 1) ? atoi(argv[0]) : -1;
+	if (mode < 0 || mode > 1 || (mode == 1 && argc < 2)) {
+		emul_error(dev);
+		return;
+	}
+
+	/* No peer ever connects, the server only has to come up */
+	emul_ok(dev);
+	emul_line(dev, mode ? "SERVER OK" : "SERVER CLOSE");
+}
+
+/* AT+CDNSGIP="<name>" */
+static void emul_cmd_cdnsgip(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	const struct sim800l_emul_config *cfg = dev->config;
+	char *argv[EMUL_MAX_ARGS];
+
+	if (emul_parse_args(args, argv, ARRAY_SIZE(argv)) < 1) {
+		emul_error(dev);
+		return;
+	}
+
+	strncpy(data->dns_name, argv[0], sizeof(data->dns_name) - 1);
+	data->dns_name[sizeof(data->dns_name) - 1] = '\0';
+
+	emul_ok(dev);
+	k_work_schedule_for_queue(&emul_work_q, &data->dns_work,
+				  K_MSEC(2 * cfg->network_latency_ms));
+}
+
+/* AT+SAPBR=2,1 */
+static void emul_cmd_sapbr_query(const struct device *dev, char *args)
+{
+	ARG_UNUSED(args);
+
+	emul_line(dev, "+SAPBR: 1,1,\"10.0.0.3\"");
+	emul_ok(dev);
+}
+
+/* AT+FTPGETNAME="<name>" */
+static void emul_cmd_ftpgetname(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	char *argv[EMUL_MAX_ARGS];
+
+	if (emul_parse_args(args, argv, ARRAY_SIZE(argv)) < 1) {
+		emul_error(dev);
+		return;
+	}
+
+	data->ftp_size = strtoul(argv[0], NULL, 10);
+	data->ftp_rest = 0;
+	emul_ok(dev);
+}
+
+/* AT+FTPREST=<offset> */
+static void emul_cmd_ftprest(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	data->ftp_rest = strtoul(args, NULL, 10);
+	emul_ok(dev);
+}
+
+/* AT+FTPGET=1 or AT+FTPGET=2,<reqlength> */
+static void emul_cmd_ftpget(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	const struct sim800l_emul_config *cfg = dev->config;
+	uint8_t payload[EMUL_MAX_RECEIVE];
+	char *argv[EMUL_MAX_ARGS];
+	size_t len;
+	int argc;
+
+	argc = emul_parse_args(args, argv, ARRAY_SIZE(argv));
+	if (argc == 1 && atoi(argv[0]) == 1) {
+		data->ftp_left = data->ftp_size - MIN(data->ftp_rest, data->ftp_size);
+		emul_ok(dev);
+		k_work_schedule_for_queue(&emul_work_q, &data->ftp_work,
+					  K_MSEC(4 * cfg->network_latency_ms));
+		return;
+	}
+
+	if (argc != 2 || atoi(argv[0]) != 2) {
+		emul_error(dev);
+		return;
+	}
+
+	len = MIN(MIN(strtoul(argv[1], NULL, 10), data->ftp_left), sizeof(payload));
+	for (size_t i = 0; i < len; i++) {
+		payload[i] = 'A' + ((data->ftp_size - data->ftp_left + i) % 26);
+	}
+
+	emul_line(dev, "+FTPGET: 2,%zu", len);
+	if (len > 0) {
+		emul_write(dev, payload, len);
+		data->ftp_left -= len;
+	}
+	emul_ok(dev);
+
+	if (len > 0 && data->ftp_left == 0) {
+		k_work_schedule_for_queue(&emul_work_q, &data->ftp_work,
+					  emul_delay(cfg, cfg->network_latency_ms, 0));
+	}
+}
+
+/* AT+HTTPPARA="<tag>","<value>" */
+static void emul_cmd_httppara(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	char *argv[EMUL_MAX_ARGS];
+	char *size;
+
+	if (emul_parse_args(args, argv, ARRAY_SIZE(argv)) < 2) {
+		emul_error(dev);
+		return;
+	}
+
+	if (strcmp(argv[0], "URL") == 0) {
+		size = strrchr(argv[1], '/');
+		data->http_get_size = size ? strtoul(size + 1, NULL, 10) : 0;
+	}
+
+	emul_ok(dev);
+}
+
+/* AT+HTTPDATA=<size>,<time> */
+static void emul_cmd_httpdata(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	size_t len = strtoul(args, NULL, 10);
+
+	if (len == 0 || len > sizeof(data->send_buf)) {
+		emul_error(dev);
+		return;
+	}
+
+	data->http_data = true;
+	data->send_link = NULL;
+	data->send_left = len;
+	data->send_len = 0;
+
+	emul_line(dev, "DOWNLOAD");
+}
+
+/* AT+HTTPACTION=<method> */
+static void emul_cmd_httpaction(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	const struct sim800l_emul_config *cfg = dev->config;
+
+	data->http_method = atoi(args);
+	emul_ok(dev);
+	k_work_schedule_for_queue(&emul_work_q, &data->http_work,
+				  emul_delay(cfg, 2 * cfg->network_latency_ms, data->http_len));
+}
+
+/* AT+HTTPREAD=<start>,<size> */
+static void emul_cmd_httpread(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+	char *argv[EMUL_MAX_ARGS];
+	size_t start;
+	size_t len;
+
+	if (emul_parse_args(args, argv, ARRAY_SIZE(argv)) != 2) {
+		emul_error(dev);
+		return;
+	}
+
+	start = MIN(strtoul(argv[0], NULL, 10), data->http_len);
+	len = MIN(strtoul(argv[1], NULL, 10), data->http_len - start);
+
+	emul_line(dev, "+HTTPREAD: %zu", len);
+	emul_write(dev, data->http_body + start, len);
+	emul_ok(dev);
+}
+
+/* AT+HTTPTERM */
+static void emul_cmd_httpterm(const struct device *dev, char *args)
+{
+	struct sim800l_emul_data *data = dev->data;
+
+	ARG_UNUSED(args);
+
+	k_work_cancel_delayable(&data->http_work);
+	data->http_len = 0;
+	emul_ok(dev);
+}
+
+/*
+ * Supported commands, matched by prefix after the leading "AT". Longer
+ * prefixes must come before shorter ones sharing the same start.
+ */
+static const struct emul_cmd emul_cmds[] = {
+	{"E0", emul_cmd_echo_off},
+	{"E1", emul_cmd_echo_on},
+	{"+CGMI", emul_cmd_cgmi},
+	{"+CGMM", emul_cmd_cgmm},
+	{"+CGMR", emul_cmd_cgmr},
+	{"+CGSN", emul_cmd_cgsn},
+	{"+CIMI", emul_cmd_cimi},
+	{"+CCID", emul_cmd_ccid},
+	{"+CSQ", emul_cmd_csq},
+	{"+CREG?", emul_cmd_creg},
+	{"+CREG=", emul_cmd_ok},
+	{"+CGATT?", emul_cmd_cgatt},
+	{"+CIPMUX=", emul_cmd_ok},
+	{"+CIPSRIP=", emul_cmd_cipsrip},
+	{"+CIPSSL=", emul_cmd_ok},
+	{"+SSLOPT=", emul_cmd_ok},
+	{"+CIPTKA=", emul_cmd_ok},
+	{"+CSTT=", emul_cmd_ok},
+	{"+CIICR", emul_cmd_ok},
+	{"+CIFSR", emul_cmd_cifsr},
+	{"+CIPSTART=", emul_cmd_cipstart},
+	{"+CIPSEND=", emul_cmd_cipsend},
+	{"+CIPCLOSE=", emul_cmd_cipclose},
+	{"+CIPSHUT", emul_cmd_cipshut},
+	{"+CIPSERVER=", emul_cmd_cipserver},
+	{"+CDNSGIP=", emul_cmd_cdnsgip},
+	{"+SAPBR=2,1", emul_cmd_sapbr_query},
+	{"+SAPBR=", emul_cmd_ok},
+	{"+FTPCID=", emul_cmd_ok},
+	{"+FTPSERV=", emul_cmd_ok},
+	{"+FTPPORT=", emul_cmd_ok},
+	{"+FTPUN=", emul_cmd_ok},
+	{"+FTPPW=", emul_cmd_ok},
+	{"+FTPGETPATH=", emul_cmd_ok},
+	{"+FTPGETNAME=", emul_cmd_ftpgetname},
+	{"+FTPREST=", emul_cmd_ftprest},
+	{"+FTPGET=", emul_cmd_ftpget},
+	{"+FTPQUIT", emul_cmd_ok},
+	{"+HTTPINIT", emul_cmd_ok},
+	{"+HTTPPARA=", emul_cmd_httppara},
+	{"+HTTPSSL=", emul_cmd_ok},
+	{"+HTTPDATA=", emul_cmd_httpdata},
+	{"+HTTPACTION=", emul_cmd_httpaction},
+	{"+HTTPREAD=", emul_cmd_httpread},
+	{"+HTTPTERM", emul_cmd_httpterm},
+	{"", emul_cmd_at},
+};
+
+static void emul_handle_line(const struct device *dev, char *line)
+{
+	LOG_DBG("AT cmd: %s", line);
+
+	if (strncmp(line, "AT", 2) != 0) {
+		return;
+	}
+
+	line += 2;
+
+	for (size_t i = 0; i < ARRAY_SIZE(emul_cmds); i++) {
+		size_t len = strlen(emul_cmds[i].prefix);
+
+		if (strncmp(line, emul_cmds[i].prefix, len) != 0) {
+			continue;
+		}
+
+		/* Plain AT must not swallow unknown commands */
+		if (len == 0 && line[0] != '\0') {
+			break;
+		}
+
+		emul_cmds[i].handler(dev, line + len);
+		return;
+	}
+
+	LOG_WRN("Unsupported command AT%s", line);
+	emul_error(dev);
+}
+
+static void emul_cmd_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_emul_data *data = CONTAINER_OF(dwork, struct sim800l_emul_data, cmd_work);
+	const struct sim800l_emul_config *cfg = data->dev->config;
+	char line[EMUL_LINE_MAX];
+
+	while (k_msgq_get(cfg->cmd_msgq, line, K_NO_WAIT) == 0) {
+		emul_handle_line(data->dev, line);
+	}
+}
+
+static void emul_rx_byte(const struct device *dev, uint8_t c)
+{
+	struct sim800l_emul_data *data = dev->data;
+	const struct sim800l_emul_config *cfg = dev->config;
+
+	if (data->send_left > 0) {
+		data->send_buf[data->send_len++] = c;
+		if (--data->send_left == 0) {
+			k_work_schedule_for_queue(
+				&emul_work_q, &data->send_work,
+				emul_delay(cfg, cfg->response_latency_ms, data->send_len));
+		}
+		return;
+	}
+
+	switch (c) {
+	case '\r':
+		if (data->line_len == 0) {
+			return;
+		}
+
+		data->line[data->line_len] = '\0';
+		data->line_len = 0;
+
+		if (data->echo) {
+			emul_write(dev, data->line, strlen(data->line));
+			emul_write(dev, "\r", 1);
+		}
+
+		if (k_msgq_put(cfg->cmd_msgq, data->line, K_NO_WAIT) < 0) {
+			LOG_WRN("Command queue full, dropped %s", data->line);
+			return;
+		}
+
+		k_work_schedule_for_queue(&emul_work_q, &data->cmd_work,
+					  K_MSEC(cfg->response_latency_ms));
+		return;
+	case '\n':
+	case 0x1A:
+		/* Line feeds and the Ctrl+Z trailing a payload are ignored */
+		return;
+	default:
+		if (data->line_len < sizeof(data->line) - 1) {
+			data->line[data->line_len++] = c;
+		}
+		return;
+	}
+}
+
+static void emul_tx_work(struct k_work *work)
+{
+	struct sim800l_emul_data *data = CONTAINER_OF(work, struct sim800l_emul_data, tx_work);
+	const struct sim800l_emul_config *cfg = data->dev->config;
+	uint8_t buf[64];
+	uint32_t len;
+
+	while ((len = uart_emul_get_tx_data(cfg->uart, buf, sizeof(buf))) > 0) {
+		for (uint32_t i = 0; i < len; i++) {
+			emul_rx_byte(data->dev, buf[i]);
+		}
+	}
+}
+
+/* Called in the context of the driver writing to the UART */
+static void emul_tx_data_ready(const struct device *uart, size_t size, void *user_data)
+{
+	struct sim800l_emul_data *data = user_data;
+
+	ARG_UNUSED(uart);
+	ARG_UNUSED(size);
+
+	k_work_submit_to_queue(&emul_work_q, &data->tx_work);
+}
+
+static int sim800l_emul_init(const struct device *dev)
+{
+	struct sim800l_emul_data *data = dev->data;
+	const struct sim800l_emul_config *cfg = dev->config;
+
+	if (!device_is_ready(cfg->uart)) {
+		LOG_ERR("UART emulator not ready");
+		return -ENODEV;
+	}
+
+	if (!emul_work_q_started) {
+		k_work_queue_start(&emul_work_q, emul_stack, K_THREAD_STACK_SIZEOF(emul_stack),
+				   K_PRIO_COOP(8), NULL);
+		k_thread_name_set(&emul_work_q.thread, "sim800l_emul");
+		emul_work_q_started = true;
+	}
+
+	data->dev = dev;
+	k_work_init(&data->tx_work, emul_tx_work);
+	k_work_init_delayable(&data->cmd_work, emul_cmd_work);
+	k_work_init_delayable(&data->boot_work, emul_boot_work);
+	k_work_init_delayable(&data->send_work, emul_send_work);
+	k_work_init_delayable(&data->dns_work, emul_dns_work);
+	k_work_init_delayable(&data->ftp_work, emul_ftp_work);
+	k_work_init_delayable(&data->http_work, emul_http_work);
+
+	for (int i = 0; i < EMUL_MAX_LINKS; i++) {
+		struct sim800l_emul_link *link = &data->links[i];
+
+		link->emul = data;
+		link->id = i;
+		ring_buf_init(&link->rx_rb, sizeof(link->rx_rb_buf), link->rx_rb_buf);
+		k_work_init_delayable(&link->connect_work, emul_link_connect_work);
+		k_work_init_delayable(&link->rx_work, emul_link_rx_work);
+	}
+
+	emul_reset(dev);
+
+#ifdef CONFIG_GPIO_EMUL
+	if (cfg->reset_gpio.port) {
+		k_work_init_delayable(&data->reset_work, emul_reset_work);
+		data->reset_level =
+			gpio_emul_output_get(cfg->reset_gpio.port, cfg->reset_gpio.pin);
+		k_work_schedule_for_queue(&emul_work_q, &data->reset_work, EMUL_RESET_POLL);
+	}
+#endif /* CONFIG_GPIO_EMUL */
+
+	uart_emul_callback_tx_data_ready_set(cfg->uart, emul_tx_data_ready, data);
+
+	LOG_DBG("SIM800L emulator on %s", cfg->uart->name);
+	return 0;
+}
+
+#define SIM800L_EMUL_DEFINE(inst)                                                                  \
+	K_MSGQ_DEFINE(sim800l_emul_msgq_##inst, EMUL_LINE_MAX, EMUL_CMD_QUEUE_LEN, 1);             \
+                                                                                                   \
+	static struct sim800l_emul_data sim800l_emul_data_##inst;                                  \
+                                                                                                   \
+	static const struct sim800l_emul_config sim800l_emul_config_##inst = {                     \
+		.uart = DEVICE_DT_GET(DT_INST_PHANDLE(inst, uart)),                                \
+		.reset_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, reset_gpios, {}),                     \
+		.cmd_msgq = &sim800l_emul_msgq_##inst,                                             \
+		.response_latency_ms = DT_INST_PROP(inst, response_latency_ms),                    \
+		.network_latency_ms = DT_INST_PROP(inst, network_latency_ms),                      \
+		.bandwidth_bps = DT_INST_PROP(inst, bandwidth_bps),                                \
+		.boot_delay_ms = DT_INST_PROP(inst, boot_delay_ms),                                \
+		.rssi = DT_INST_PROP(inst, rssi),                                                  \
+	};                                                                                         \
+                                                                                                   \
+	DEVICE_DT_INST_DEFINE(inst, sim800l_emul_init, NULL, &sim800l_emul_data_##inst,            \
+			      &sim800l_emul_config_##inst, POST_KERNEL,                            \
+			      CONFIG_MODEM_SIM800L_EMUL_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(SIM800L_EMUL_DEFINE)
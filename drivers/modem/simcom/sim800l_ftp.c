@@ -0,0 +1,354 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Streaming FTP downloads using the modem FTP application.
+ *
+ * AT+FTPGET=1 opens the session, the modem answers +FTPGET: 1,1 once data
+ * can be read. Data is then pulled with AT+FTPGET=2,<len>, answered by
+ * +FTPGET: 2,<cnflen> followed by the data. A zero length means nothing is
+ * buffered yet and +FTPGET: 1,1 follows when more arrives, +FTPGET: 1,0
+ * reports the end of the transfer.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#ifdef CONFIG_MODEM_SIM800L_FTP_FLASH
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/storage/stream_flash.h>
+#endif
+
+#include <drivers/sim800l.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_ftp, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+#define FTP_DEFAULT_PORT 21
+
+/* +FTPGET: 1,<code> */
+#define FTP_URC_FINISHED 0
+#define FTP_URC_DATA     1
+
+/*
+ * +FTPGET: 2,<cnflength>\r\n<data>
+ *
+ * Stores the data in the chunk buffer selected by ftp.fill.
+ */
+MODEM_CMD_DEFINE(on_cmd_ftpget_data)
+{
+	struct sim800l_data *mdata = data->user_data;
+	int fill = mdata->ftp.fill;
+	int cnf_len = atoi(argv[0]);
+
+	mdata->ftp.len[fill] = 0;
+	if (cnf_len > 0) {
+		mdata->ftp.len[fill] = modem_read_payload(mdata, -1, mdata->ftp.buf[fill],
+							  sizeof(mdata->ftp.buf[fill]), cnf_len);
+	}
+
+	LOG_DBG("FTP chunk %d: %zu bytes", fill, mdata->ftp.len[fill]);
+	return 0;
+}
+
+void modem_ftp_init(struct sim800l_data *mdata)
+{
+	k_mutex_init(&mdata->ftp.lock);
+	k_sem_init(&mdata->ftp.sem_urc, 0, 1);
+}
+
+/* Called from the +FTPGET: 1,<code> URC */
+void modem_ftp_urc(struct sim800l_data *mdata, int code)
+{
+	mdata->ftp.urc = code;
+	k_sem_give(&mdata->ftp.sem_urc);
+}
+
+static int ftp_error(int code)
+{
+	LOG_ERR("FTP error %d", code);
+
+	switch (code) {
+	case 62:
+		/* DNS error */
+		return -EHOSTUNREACH;
+	case 63:
+		/* Connect error */
+		return -ECONNREFUSED;
+	case 64:
+		/* Timeout */
+		return -ETIMEDOUT;
+	case 71:
+	case 72:
+		/* User or password error */
+		return -EACCES;
+	default:
+		return -EIO;
+	}
+}
+
+/*
+ * Wait for +FTPGET: 1,<code>.
+ *
+ * Returns 1 when data is available, 0 when the transfer finished.
+ */
+static int ftp_wait_urc(struct sim800l_data *mdata)
+{
+	if (k_sem_take(&mdata->ftp.sem_urc, MDM_FTP_TIMEOUT) < 0) {
+		LOG_ERR("FTP server did not respond");
+		return -ETIMEDOUT;
+	}
+
+	switch (mdata->ftp.urc) {
+	case FTP_URC_DATA:
+		return 1;
+	case FTP_URC_FINISHED:
+		return 0;
+	default:
+		return ftp_error(mdata->ftp.urc);
+	}
+}
+
+static int ftp_param(struct sim800l_data *mdata, const char *fmt, ...)
+{
+	char buf[128];
+	va_list args;
+	int ret;
+
+	va_start(args, fmt);
+	ret = vsnprintk(buf, sizeof(buf), fmt, args);
+	va_end(args);
+
+	if (ret < 0 || ret >= sizeof(buf)) {
+		return -ENAMETOOLONG;
+	}
+
+	return modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, buf);
+}
+
+/*
+ * Configure the session and start the transfer.
+ *
+ * Returns 1 when data is available, 0 for an empty file.
+ */
+static int ftp_open(struct sim800l_data *mdata, const struct sim800l_ftp_config *cfg)
+{
+	int ret;
+
+	ret = ftp_param(mdata, "AT+FTPCID=1");
+	if (ret == 0) {
+		ret = ftp_param(mdata, "AT+FTPSERV=\"%s\"", cfg->server);
+	}
+	if (ret == 0) {
+		ret = ftp_param(mdata, "AT+FTPPORT=%u", cfg->port ? cfg->port : FTP_DEFAULT_PORT);
+	}
+	if (ret == 0) {
+		ret = ftp_param(mdata, "AT+FTPUN=\"%s\"", cfg->user ? cfg->user : "anonymous");
+	}
+	if (ret == 0) {
+		ret = ftp_param(mdata, "AT+FTPPW=\"%s\"", cfg->password ? cfg->password : "");
+	}
+	if (ret == 0) {
+		ret = ftp_param(mdata, "AT+FTPGETPATH=\"%s\"", cfg->path ? cfg->path : "/");
+	}
+	if (ret == 0) {
+		ret = ftp_param(mdata, "AT+FTPGETNAME=\"%s\"", cfg->filename);
+	}
+	if (ret == 0 && cfg->offset > 0) {
+		ret = ftp_param(mdata, "AT+FTPREST=%zu", cfg->offset);
+	}
+	if (ret < 0) {
+		LOG_ERR("Failed to configure FTP session: %d", ret);
+		return ret;
+	}
+
+	k_sem_reset(&mdata->ftp.sem_urc);
+
+	ret = ftp_param(mdata, "AT+FTPGET=1");
+	if (ret < 0) {
+		LOG_ERR("Failed to open FTP session: %d", ret);
+		return ret;
+	}
+
+	return ftp_wait_urc(mdata);
+}
+
+static void ftp_quit(struct sim800l_data *mdata)
+{
+	if (ftp_param(mdata, "AT+FTPQUIT") < 0) {
+		LOG_WRN("Failed to quit FTP session");
+	}
+}
+
+/*
+ * Read the next chunk into buffer idx. The AT channel is held from the
+ * command to its OK only, so no other command is interleaved with the
+ * binary response and none waits for the caller.
+ */
+static int ftp_read_chunk(struct sim800l_data *mdata, int idx)
+{
+	static const struct modem_cmd cmd[] = {
+		MODEM_CMD("+FTPGET: 2,", on_cmd_ftpget_data, 1U, ""),
+	};
+	char buf[sizeof("AT+FTPGET=2,####")];
+
+	mdata->ftp.fill = idx;
+	mdata->ftp.len[idx] = 0;
+	snprintk(buf, sizeof(buf), "AT+FTPGET=2,%d", CONFIG_MODEM_SIM800L_FTP_CHUNK_SIZE);
+
+	return modem_at_send(mdata, MDM_AT_CONTROL, cmd, ARRAY_SIZE(cmd), buf, MDM_CMD_TIMEOUT);
+}
+
+int sim800l_ftp_get(const struct device *dev, const struct sim800l_ftp_config *cfg,
+		    sim800l_ftp_data_cb_t cb, void *user_data)
+{
+	struct sim800l_data *mdata = dev->data;
+	size_t offset;
+	int cur = 0;
+	int ret;
+
+	if (!cfg || !cfg->server || !cfg->filename || !cb) {
+		return -EINVAL;
+	}
+
+	if (mdata->state != SIM800L_STATE_READY) {
+		return -ENETDOWN;
+	}
+
+	k_mutex_lock(&mdata->ftp.lock, K_FOREVER);
+
+	ret = modem_bearer_open(mdata);
+	if (ret < 0) {
+		goto unlock;
+	}
+
+	ret = ftp_open(mdata, cfg);
+	if (ret <= 0) {
+		/* Error, or an empty file that is already complete */
+		goto done;
+	}
+
+	offset = cfg->offset;
+	ret = ftp_read_chunk(mdata, cur);
+
+	while (ret == 0) {
+		size_t len = mdata->ftp.len[cur];
+		int next = !cur;
+		int cb_ret;
+
+		if (len == 0) {
+			/* Nothing buffered on the modem, wait for more or the end */
+			ret = ftp_wait_urc(mdata);
+			if (ret <= 0) {
+				break;
+			}
+
+			ret = ftp_read_chunk(mdata, cur);
+			continue;
+		}
+
+		/*
+		 * Fetch the next chunk into the spare buffer before the
+		 * callback. The read is complete when the callback runs, so it
+		 * gets the AT channel free for other modem functions. A failed
+		 * read still hands over the current chunk.
+		 */
+		ret = ftp_read_chunk(mdata, next);
+
+		cb_ret = cb(mdata->ftp.buf[cur], len, offset, user_data);
+		if (cb_ret < 0) {
+			LOG_WRN("FTP download aborted by callback: %d", cb_ret);
+			ret = cb_ret;
+			break;
+		}
+
+		offset += len;
+		cur = next;
+	}
+
+	if (ret == 0) {
+		LOG_INF("FTP download of %s done, %zu bytes", cfg->filename,
+			offset - cfg->offset);
+	}
+
+done:
+	if (ret < 0) {
+		ftp_quit(mdata);
+	}
+
+unlock:
+	k_mutex_unlock(&mdata->ftp.lock);
+	return ret;
+}
+
+#ifdef CONFIG_MODEM_SIM800L_FTP_FLASH
+static int ftp_flash_write(const uint8_t *data, size_t len, size_t offset, void *user_data)
+{
+	struct stream_flash_ctx *stream = user_data;
+
+	ARG_UNUSED(offset);
+
+	return stream_flash_buffered_write(stream, data, len, false);
+}
+
+int sim800l_ftp_get_to_flash(const struct device *dev, const struct sim800l_ftp_config *cfg,
+			     uint8_t area_id, size_t *size)
+{
+	uint8_t buf[CONFIG_MODEM_SIM800L_FTP_FLASH_BUF_SIZE];
+	const struct flash_area *fa;
+	struct stream_flash_ctx stream;
+	int ret;
+
+	if (!cfg) {
+		return -EINVAL;
+	}
+
+	ret = flash_area_open(area_id, &fa);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/*
+	 * A resume writes behind the data already in the area and relies on
+	 * the rest still being erased by the first attempt. The offset must
+	 * be one reported through size, those are write block aligned.
+	 */
+	if (cfg->offset >= fa->fa_size ||
+	    cfg->offset % flash_get_write_block_size(flash_area_get_device(fa)) != 0) {
+		ret = -EINVAL;
+		goto close;
+	}
+
+	if (cfg->offset == 0) {
+		ret = flash_area_erase(fa, 0, fa->fa_size);
+		if (ret < 0) {
+			LOG_ERR("Failed to erase flash area %u: %d", area_id, ret);
+			goto close;
+		}
+	}
+
+	ret = stream_flash_init(&stream, flash_area_get_device(fa), buf, sizeof(buf),
+				fa->fa_off + cfg->offset, fa->fa_size - cfg->offset, NULL);
+	if (ret < 0) {
+		goto close;
+	}
+
+	ret = sim800l_ftp_get(dev, cfg, ftp_flash_write, &stream);
+	if (ret == 0) {
+		ret = stream_flash_buffered_write(&stream, NULL, 0, true);
+	}
+
+	if (size) {
+		*size = cfg->offset + stream_flash_bytes_written(&stream);
+	}
+
+close:
+	flash_area_close(fa);
+	return ret;
+}
+#endif /* CONFIG_MODEM_SIM800L_FTP_FLASH */
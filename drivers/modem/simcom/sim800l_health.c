@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Stuck modem detection and graded recovery.
+ *
+ * Missed answers are counted and the time of the last byte received is
+ * kept. Too many missed answers in a row start a recovery, a silent line
+ * only a probe with AT. Recovery escalates one step each time it is needed
+ * again shortly after the last one, and also when a step fails:
+ *
+ *  1. AT until the command parser is in sync again
+ *  2. AT+CIPSHUT and PDP context activation
+ *  3. Reset through the reset GPIO and a full boot
+ *
+ * After a quiet period the next recovery starts at the first step again.
+ *
+ * The checks and the recovery run on the control work queue of the modem,
+ * a reboot takes tens of seconds. A modem sleeping on DTR is quiet by
+ * design and not probed, that would wake it.
+ */
+
+#include <zephyr/logging/log.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_health, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Attempts of the AT resync step */
+#define HEALTH_RESYNC_TRIES 3
+
+/* Quiet time in ms after which recovery starts at the first step again */
+#define HEALTH_DECAY_MS (10 * MSEC_PER_SEC * 60)
+
+/* Delay before a failed recovery is retried */
+#define HEALTH_RETRY_DELAY K_SECONDS(60)
+
+/* Check interval while the modem answers */
+#define HEALTH_PERIOD K_SECONDS(CONFIG_MODEM_SIM800L_HEALTH_SILENCE)
+
+enum health_step {
+	HEALTH_RESYNC = 0,
+	HEALTH_PDP,
+	HEALTH_REBOOT,
+};
+
+static void health_schedule(struct sim800l_data *mdata, k_timeout_t delay)
+{
+	k_work_reschedule_for_queue(&mdata->ctl_workq, &mdata->health.work, delay);
+}
+
+/* The links are gone with the PDP context, fail their sockets */
+static void health_links_lost(struct sim800l_data *mdata)
+{
+	for (int link = 0; link < MDM_MAX_SOCKETS; link++) {
+		modem_urc_closed(mdata, link);
+	}
+}
+
+static int health_resync(struct sim800l_data *mdata)
+{
+	int ret = -EIO;
+
+	for (int i = 0; i < HEALTH_RESYNC_TRIES && ret < 0; i++) {
+		ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, "AT");
+	}
+
+	return ret;
+}
+
+static int health_pdp(struct sim800l_data *mdata)
+{
+	int ret;
+
+	ret = modem_pdp_deactivate(mdata);
+	if (ret < 0) {
+		return ret;
+	}
+
+	health_links_lost(mdata);
+
+	return modem_pdp_activate(mdata);
+}
+
+static int health_step_run(struct sim800l_data *mdata, enum health_step step)
+{
+	LOG_WRN("Modem not answering, recovery step %d", step + 1);
+
+	switch (step) {
+	case HEALTH_RESYNC:
+		return health_resync(mdata);
+	case HEALTH_PDP:
+		return health_pdp(mdata);
+	default:
+		health_links_lost(mdata);
+		return modem_reboot(mdata);
+	}
+}
+
+static void health_recover(struct sim800l_data *mdata)
+{
+	int64_t now = k_uptime_get();
+	int step = mdata->health.step;
+	int ret = -EIO;
+
+	if (now - mdata->health.recovered > HEALTH_DECAY_MS) {
+		step = HEALTH_RESYNC;
+	}
+
+	for (; step <= HEALTH_REBOOT && ret < 0; step++) {
+		ret = health_step_run(mdata, step);
+	}
+
+	if (ret < 0) {
+		LOG_ERR("Modem recovery failed: %d", ret);
+		mdata->health.step = HEALTH_REBOOT;
+		health_schedule(mdata, HEALTH_RETRY_DELAY);
+		return;
+	}
+
+	LOG_INF("Modem recovered at step %d", step);
+
+	/* The same trouble again soon takes the next step */
+	mdata->health.step = MIN(step, HEALTH_REBOOT);
+	mdata->health.recovered = k_uptime_get();
+	atomic_clear(&mdata->health.timeouts);
+}
+
+static void health_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_data *mdata = CONTAINER_OF(dwork, struct sim800l_data, health.work);
+	int64_t silence = k_uptime_get() - mdata->health.last_rx;
+	bool stuck;
+
+	if (!mdata->powered) {
+		return;
+	}
+
+	stuck = atomic_get(&mdata->health.timeouts) >= CONFIG_MODEM_SIM800L_HEALTH_MAX_TIMEOUTS;
+
+#ifdef CONFIG_MODEM_SIM800L_SLEEP
+	if (mdata->sleep.asleep) {
+		silence = 0;
+	}
+#endif
+
+	if (!stuck && silence < CONFIG_MODEM_SIM800L_HEALTH_SILENCE * MSEC_PER_SEC) {
+		health_schedule(mdata, HEALTH_PERIOD);
+		return;
+	}
+
+	/* A quiet line is fine as long as the modem answers */
+	atomic_set(&mdata->health.checking, 1);
+	if (stuck || health_resync(mdata) < 0) {
+		health_recover(mdata);
+	}
+	atomic_set(&mdata->health.checking, 0);
+
+	if (mdata->powered && !k_work_delayable_is_pending(dwork)) {
+		health_schedule(mdata, HEALTH_PERIOD);
+	}
+}
+
+/*
+ * A command or a socket operation got no answer in time. The probes and
+ * steps of a running check only count, the check itself decides what comes
+ * next.
+ */
+void modem_health_timeout(struct sim800l_data *mdata)
+{
+	if (atomic_inc(&mdata->health.timeouts) + 1 == CONFIG_MODEM_SIM800L_HEALTH_MAX_TIMEOUTS &&
+	    !atomic_get(&mdata->health.checking)) {
+		health_schedule(mdata, K_NO_WAIT);
+	}
+}
+
+/* The modem answered */
+void modem_health_answer(struct sim800l_data *mdata)
+{
+	atomic_clear(&mdata->health.timeouts);
+}
+
+void modem_health_init(struct sim800l_data *mdata)
+{
+	k_work_init_delayable(&mdata->health.work, health_work);
+	atomic_clear(&mdata->health.timeouts);
+	atomic_clear(&mdata->health.checking);
+	mdata->health.step = HEALTH_RESYNC;
+	mdata->health.recovered = 0;
+}
+
+void modem_health_start(struct sim800l_data *mdata)
+{
+	atomic_clear(&mdata->health.timeouts);
+	mdata->health.last_rx = k_uptime_get();
+	health_schedule(mdata, HEALTH_PERIOD);
+}
+
+void modem_health_stop(struct sim800l_data *mdata)
+{
+	k_work_cancel_delayable(&mdata->health.work);
+}
@@ -0,0 +1,354 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * HTTP client using the modem HTTP application.
+ *
+ * A request is set up with AT+HTTPINIT and AT+HTTPPARA, the body is written
+ * after the DOWNLOAD prompt of AT+HTTPDATA and AT+HTTPACTION runs it. The
+ * modem keeps the response and reports it with
+ * +HTTPACTION: <method>,<status>,<datalen>, the body is then fetched in
+ * chunks with AT+HTTPREAD=<start>,<size>.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <drivers/sim800l.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_http, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Time the modem waits for the AT+HTTPDATA body */
+#define HTTP_DATA_TIMEOUT_MS 10000
+
+/* Status codes above this are modem errors, not server responses */
+#define HTTP_MODEM_ERROR 600
+
+/* Largest body AT+HTTPDATA accepts */
+#define HTTP_DATA_MAX 319488
+
+/* Prompt for the request body */
+MODEM_CMD_DEFINE(on_cmd_http_download)
+{
+	struct sim800l_data *mdata = data->user_data;
+
+	k_sem_give(&mdata->sem_tx_ready);
+	return 0;
+}
+
+/*
+ * +HTTPREAD: <len>\r\n<data>
+ *
+ * Stores the data in the caller buffer set up by sim800l_http_read().
+ */
+MODEM_CMD_DEFINE(on_cmd_httpread)
+{
+	struct sim800l_data *mdata = data->user_data;
+	int len = atoi(argv[0]);
+
+	mdata->http.got = 0;
+	if (len > 0) {
+		mdata->http.got = modem_read_payload(mdata, -1, mdata->http.dst, mdata->http.room,
+						     len);
+	}
+
+	return 0;
+}
+
+void modem_http_init(struct sim800l_data *mdata)
+{
+	k_mutex_init(&mdata->http.lock);
+	k_sem_init(&mdata->http.sem_action, 0, 1);
+}
+
+/* Called from the +HTTPACTION: <method>,<status>,<datalen> URC */
+void modem_http_action(struct sim800l_data *mdata, int status, size_t len)
+{
+	mdata->http.status = status;
+	mdata->http.content_len = len;
+	k_sem_give(&mdata->http.sem_action);
+}
+
+static int http_cmd(struct sim800l_data *mdata, const char *fmt, ...)
+{
+	char buf[256];
+	va_list args;
+	int ret;
+
+	va_start(args, fmt);
+	ret = vsnprintk(buf, sizeof(buf), fmt, args);
+	va_end(args);
+
+	if (ret < 0 || ret >= sizeof(buf)) {
+		return -ENAMETOOLONG;
+	}
+
+	return modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, buf);
+}
+
+/*
+ * AT+HTTPDATA=<size>,<time>
+ * DOWNLOAD
+ * <body>
+ * OK
+ */
+static int http_send_body(struct sim800l_data *mdata, const void *body, size_t len)
+{
+	static const struct modem_cmd cmd[] = {
+		MODEM_CMD("DOWNLOAD", on_cmd_http_download, 0U, ""),
+	};
+	char buf[sizeof("AT+HTTPDATA=######,#####")];
+	int ret;
+
+	if (len > HTTP_DATA_MAX) {
+		return -EMSGSIZE;
+	}
+
+	ret = snprintk(buf, sizeof(buf), "AT+HTTPDATA=%zu,%d", len, HTTP_DATA_TIMEOUT_MS);
+	if (ret < 0 || ret >= sizeof(buf)) {
+		return -EMSGSIZE;
+	}
+
+	ret = modem_at_acquire(mdata, MDM_AT_CONTROL, sys_timepoint_calc(MDM_CMD_TIMEOUT));
+	if (ret < 0) {
+		return ret;
+	}
+
+	k_sem_take(&mdata->cmd_handler_data.sem_tx_lock, K_FOREVER);
+	k_sem_reset(&mdata->sem_tx_ready);
+
+	ret = modem_cmd_send_ext(&mdata->ctx.iface, &mdata->ctx.cmd_handler, cmd, ARRAY_SIZE(cmd),
+				 buf, NULL, K_NO_WAIT, MODEM_NO_TX_LOCK | MODEM_NO_UNSET_CMDS);
+	if (ret < 0) {
+		goto exit;
+	}
+
+	if (k_sem_take(&mdata->sem_tx_ready, MDM_CMD_TIMEOUT) < 0) {
+		LOG_ERR("No DOWNLOAD prompt");
+		ret = -ETIMEDOUT;
+		goto exit;
+	}
+
+	k_sem_reset(&mdata->sem_response);
+	modem_cmd_send_data_nolock(&mdata->ctx.iface, body, len);
+
+	ret = k_sem_take(&mdata->sem_response, MDM_CMD_TIMEOUT);
+	if (ret == 0) {
+		ret = modem_cmd_handler_get_error(&mdata->cmd_handler_data);
+	} else {
+		ret = -ETIMEDOUT;
+	}
+
+exit:
+	modem_cmd_handler_update_cmds(&mdata->cmd_handler_data, NULL, 0U, false);
+	k_sem_give(&mdata->cmd_handler_data.sem_tx_lock);
+	modem_at_release(mdata);
+	return ret;
+}
+
+static int http_setup(struct sim800l_data *mdata, const struct sim800l_http_request *req)
+{
+	bool ssl = strncmp(req->url, "https://", 8) == 0;
+	int ret;
+
+	ret = http_cmd(mdata, "AT+HTTPINIT");
+	if (ret < 0) {
+		/* A previous session may still be open */
+		http_cmd(mdata, "AT+HTTPTERM");
+		ret = http_cmd(mdata, "AT+HTTPINIT");
+	}
+	if (ret < 0) {
+		LOG_ERR("Failed to start HTTP session: %d", ret);
+		return ret;
+	}
+
+	ret = http_cmd(mdata, "AT+HTTPPARA=\"CID\",1");
+	if (ret == 0) {
+		ret = http_cmd(mdata, "AT+HTTPPARA=\"URL\",\"%s\"", req->url);
+	}
+	if (ret == 0 && req->content_type) {
+		ret = http_cmd(mdata, "AT+HTTPPARA=\"CONTENT\",\"%s\"", req->content_type);
+	}
+	if (ret == 0 && req->headers) {
+		ret = http_cmd(mdata, "AT+HTTPPARA=\"USERDATA\",\"%s\"", req->headers);
+	}
+	if (ret == 0) {
+		ret = http_cmd(mdata, "AT+HTTPSSL=%d", ssl ? 1 : 0);
+	}
+	if (ret == 0 && req->body && req->body_len > 0) {
+		ret = http_send_body(mdata, req->body, req->body_len);
+	}
+
+	if (ret < 0) {
+		LOG_ERR("Failed to set up HTTP request: %d", ret);
+	}
+
+	return ret;
+}
+
+int sim800l_http_request(const struct device *dev, const struct sim800l_http_request *req,
+			 int *status, size_t *content_len)
+{
+	struct sim800l_data *mdata = dev->data;
+	int ret;
+
+	if (!req || !req->url) {
+		return -EINVAL;
+	}
+
+	if (mdata->state != SIM800L_STATE_READY) {
+		return -ENETDOWN;
+	}
+
+	/* Held until sim800l_http_close() */
+	k_mutex_lock(&mdata->http.lock, K_FOREVER);
+
+	if (mdata->http.active) {
+		k_mutex_unlock(&mdata->http.lock);
+		return -EALREADY;
+	}
+
+	ret = modem_bearer_open(mdata);
+	if (ret < 0) {
+		goto unlock;
+	}
+
+	ret = http_setup(mdata, req);
+	if (ret < 0) {
+		goto term;
+	}
+
+	k_sem_reset(&mdata->http.sem_action);
+
+	ret = http_cmd(mdata, "AT+HTTPACTION=%d", req->method);
+	if (ret < 0) {
+		goto term;
+	}
+
+	if (k_sem_take(&mdata->http.sem_action, MDM_HTTP_TIMEOUT) < 0) {
+		LOG_ERR("HTTP request timed out");
+		ret = -ETIMEDOUT;
+		goto term;
+	}
+
+	if (mdata->http.status >= HTTP_MODEM_ERROR) {
+		LOG_ERR("HTTP request failed on the modem: %d", mdata->http.status);
+		ret = -EIO;
+		goto term;
+	}
+
+	LOG_DBG("HTTP %d, %zu bytes", mdata->http.status, mdata->http.content_len);
+
+	if (status) {
+		*status = mdata->http.status;
+	}
+	if (content_len) {
+		*content_len = mdata->http.content_len;
+	}
+
+	mdata->http.read_offset = 0;
+	mdata->http.active = true;
+	return 0;
+
+term:
+	http_cmd(mdata, "AT+HTTPTERM");
+unlock:
+	k_mutex_unlock(&mdata->http.lock);
+	return ret;
+}
+
+/*
+ * Lock the session again in the thread holding it since
+ * sim800l_http_request(), another thread gets -EPERM.
+ */
+static int http_session_get(struct sim800l_data *mdata)
+{
+	if (k_mutex_lock(&mdata->http.lock, K_NO_WAIT) < 0) {
+		return -EPERM;
+	}
+
+	if (!mdata->http.active) {
+		k_mutex_unlock(&mdata->http.lock);
+		return -EBADF;
+	}
+
+	return 0;
+}
+
+int sim800l_http_read(const struct device *dev, void *buf, size_t len)
+{
+	static const struct modem_cmd cmd[] = {
+		MODEM_CMD("+HTTPREAD: ", on_cmd_httpread, 1U, ""),
+	};
+	struct sim800l_data *mdata = dev->data;
+	char read_cmd[sizeof("AT+HTTPREAD=##########,#####")];
+	size_t total = 0;
+	int ret;
+
+	ret = http_session_get(mdata);
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (total < len && mdata->http.read_offset < mdata->http.content_len) {
+		size_t chunk = MIN(len - total, CONFIG_MODEM_SIM800L_HTTP_READ_CHUNK_SIZE);
+
+		chunk = MIN(chunk, mdata->http.content_len - mdata->http.read_offset);
+
+		mdata->http.dst = (uint8_t *)buf + total;
+		mdata->http.room = chunk;
+		mdata->http.got = 0;
+
+		snprintk(read_cmd, sizeof(read_cmd), "AT+HTTPREAD=%zu,%zu", mdata->http.read_offset,
+			 chunk);
+		ret = modem_at_send(mdata, MDM_AT_CONTROL, cmd, ARRAY_SIZE(cmd), read_cmd,
+				    MDM_CMD_TIMEOUT);
+		if (ret < 0) {
+			LOG_ERR("HTTP read failed: %d", ret);
+			break;
+		}
+
+		if (mdata->http.got == 0) {
+			break;
+		}
+
+		mdata->http.read_offset += mdata->http.got;
+		total += mdata->http.got;
+	}
+
+	k_mutex_unlock(&mdata->http.lock);
+
+	/* Data read before a failure is still returned */
+	if (ret < 0 && total == 0) {
+		return ret;
+	}
+
+	return total;
+}
+
+int sim800l_http_close(const struct device *dev)
+{
+	struct sim800l_data *mdata = dev->data;
+	int ret;
+
+	ret = http_session_get(mdata);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = http_cmd(mdata, "AT+HTTPTERM");
+	mdata->http.active = false;
+
+	/* Once for http_session_get(), once for sim800l_http_request() */
+	k_mutex_unlock(&mdata->http.lock);
+	k_mutex_unlock(&mdata->http.lock);
+
+	return ret;
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * On demand bring-up.
+ *
+ * The modem is left alone at system init and brought up by the first
+ * socket or DNS lookup. Callers arriving while a bring-up runs wait for it
+ * and share its result instead of starting their own. Every open socket
+ * and running lookup holds a runtime PM reference, once the last one is
+ * dropped the modem is suspended after the idle timeout.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_lazy, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+static bool lazy_ready(struct sim800l_data *mdata)
+{
+	uint32_t flags = SIM800L_STATUS_FLAG_BOOTED | SIM800L_STATUS_FLAG_PDP_ACTIVE;
+
+	return mdata->powered && (mdata->status_flags & flags) == flags;
+}
+
+static int lazy_bring_up(struct sim800l_data *mdata)
+{
+	uint32_t gen;
+	int ret;
+
+	k_mutex_lock(&mdata->lazy.lock, K_FOREVER);
+
+	if (lazy_ready(mdata)) {
+		k_mutex_unlock(&mdata->lazy.lock);
+		return 0;
+	}
+
+	if (mdata->lazy.busy) {
+		gen = mdata->lazy.gen;
+		while (mdata->lazy.gen == gen) {
+			k_condvar_wait(&mdata->lazy.done, &mdata->lazy.lock, K_FOREVER);
+		}
+
+		ret = mdata->lazy.result;
+		k_mutex_unlock(&mdata->lazy.lock);
+		return ret;
+	}
+
+	mdata->lazy.busy = true;
+	k_mutex_unlock(&mdata->lazy.lock);
+
+	LOG_INF("Bringing modem up on demand");
+	ret = modem_bring_up(mdata);
+
+	k_mutex_lock(&mdata->lazy.lock, K_FOREVER);
+	mdata->lazy.busy = false;
+	mdata->lazy.result = ret;
+	mdata->lazy.gen++;
+	k_condvar_broadcast(&mdata->lazy.done);
+	k_mutex_unlock(&mdata->lazy.lock);
+
+	return ret;
+}
+
+/* Take a reference on the modem, bringing it up when needed */
+int modem_lazy_get(struct sim800l_data *mdata)
+{
+	int ret;
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+	ret = pm_device_runtime_get(mdata->dev);
+	if (ret < 0) {
+		LOG_ERR("Failed to resume modem: %d", ret);
+		return ret;
+	}
+#endif
+
+	ret = lazy_bring_up(mdata);
+	if (ret < 0) {
+		LOG_ERR("On demand bring-up failed: %d", ret);
+		modem_lazy_put(mdata);
+	}
+
+	return ret;
+}
+
+/* Drop a reference, the last one starts the idle timeout */
+void modem_lazy_put(struct sim800l_data *mdata)
+{
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+	pm_device_runtime_put_async(mdata->dev, K_SECONDS(CONFIG_MODEM_SIM800L_IDLE_TIMEOUT));
+#else
+	ARG_UNUSED(mdata);
+#endif
+}
+
+void modem_lazy_init(struct sim800l_data *mdata)
+{
+	k_mutex_init(&mdata->lazy.lock);
+	k_condvar_init(&mdata->lazy.done);
+	mdata->lazy.busy = false;
+	mdata->lazy.gen = 0;
+	mdata->lazy.result = 0;
+}
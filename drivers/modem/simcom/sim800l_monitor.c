@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Background network status monitor.
+ *
+ * Signal quality, registration and GPRS attach state are refreshed from the
+ * control work queue and cached in the driver data, readers never send AT
+ * commands themselves. A refresh only starts while the AT channel is idle
+ * and its queries use the lowest AT class, so it does not delay socket
+ * traffic. The interval starts at the minimum and doubles while nothing
+ * changes.
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <drivers/sim800l.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_monitor, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Retry delay while the AT channel is in use */
+#define MONITOR_BUSY_DELAY K_MSEC(500)
+
+/* Signal change in dBm that restarts the fast refresh */
+#define MONITOR_RSSI_DELTA 6
+
+/* Signal in dBm below which the fast refresh is kept */
+#define MONITOR_RSSI_WEAK -100
+
+static bool monitor_registered(uint8_t reg)
+{
+	return reg == 1 || reg == 5;
+}
+
+static void monitor_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_data *mdata = CONTAINER_OF(dwork, struct sim800l_data, rssi_query_work);
+	uint32_t attached = mdata->status_flags & SIM800L_STATUS_FLAG_ATTACHED;
+	uint8_t reg = mdata->network_registration;
+	int rssi = mdata->rssi;
+	bool changed;
+
+	if (!mdata->powered) {
+		return;
+	}
+
+	if (!modem_at_idle(mdata)) {
+		k_work_reschedule_for_queue(&mdata->ctl_workq, dwork, MONITOR_BUSY_DELAY);
+		return;
+	}
+
+	modem_query_rssi(mdata, MDM_AT_MONITOR);
+	modem_query_registration(mdata, MDM_AT_MONITOR);
+	modem_query_attach(mdata, MDM_AT_MONITOR);
+	mdata->monitor.updated = k_uptime_get();
+
+	changed = abs(mdata->rssi - rssi) >= MONITOR_RSSI_DELTA ||
+		  mdata->network_registration != reg ||
+		  (mdata->status_flags & SIM800L_STATUS_FLAG_ATTACHED) != attached;
+
+	if (changed || !monitor_registered(mdata->network_registration) ||
+	    mdata->rssi < MONITOR_RSSI_WEAK) {
+		mdata->monitor.interval = CONFIG_MODEM_SIM800L_MONITOR_MIN_INTERVAL;
+	} else {
+		mdata->monitor.interval = MIN(mdata->monitor.interval * 2,
+					      CONFIG_MODEM_SIM800L_MONITOR_MAX_INTERVAL);
+	}
+
+	LOG_DBG("RSSI %d, CREG %u, attached %d, next in %u s", mdata->rssi,
+		mdata->network_registration,
+		(mdata->status_flags & SIM800L_STATUS_FLAG_ATTACHED) != 0, mdata->monitor.interval);
+
+	k_work_reschedule_for_queue(&mdata->ctl_workq, dwork, K_SECONDS(mdata->monitor.interval));
+}
+
+void modem_monitor_init(struct sim800l_data *mdata)
+{
+	k_work_init_delayable(&mdata->rssi_query_work, monitor_work);
+	mdata->monitor.updated = -1;
+}
+
+void modem_monitor_start(struct sim800l_data *mdata)
+{
+	mdata->monitor.interval = CONFIG_MODEM_SIM800L_MONITOR_MIN_INTERVAL;
+	mdata->monitor.updated = k_uptime_get();
+	k_work_reschedule_for_queue(&mdata->ctl_workq, &mdata->rssi_query_work,
+				    K_SECONDS(mdata->monitor.interval));
+}
+
+void modem_monitor_stop(struct sim800l_data *mdata)
+{
+	k_work_cancel_delayable(&mdata->rssi_query_work);
+}
+
+int sim800l_get_network_status(const struct device *dev, struct sim800l_network_status *status)
+{
+	struct sim800l_data *mdata = dev->data;
+
+	if (!status) {
+		return -EINVAL;
+	}
+
+	status->rssi = mdata->rssi;
+	status->registration = mdata->network_registration;
+	status->attached = (mdata->status_flags & SIM800L_STATUS_FLAG_ATTACHED) != 0;
+	status->age_ms = mdata->monitor.updated < 0 ? -1 : k_uptime_get() - mdata->monitor.updated;
+
+	return 0;
+}
@@ -10,14 +10,19 @@
 #include <zephyr/net/offloaded_netdev.h>
 #include <zephyr/net/socket_offload.h>
 #include <zephyr/net_buf.h>
+#include <zephyr/sys/fdtable.h>
 
 #include "sim800l.h"
 
 LOG_MODULE_REGISTER(modem_simcom_sim800l_offload, CONFIG_MODEM_SIM800L_LOG_LEVEL);
 
-static struct zsock_addrinfo dns_result;
-static struct sockaddr dns_result_addr;
-static char dns_result_canonname[DNS_MAX_NAME_SIZE + 1];
+/* Instances that registered a network interface */
+static struct sim800l_data *instances[MDM_MAX_INSTANCES];
+
+static inline struct sim800l_data *sock_to_mdata(struct modem_socket *sock)
+{
+	return ((struct sim800l_socket_data *)sock->data)->mdata;
+}
 
 /*
  * Parses the dns response from the modem.
@@ -30,6 +35,7 @@ static char dns_result_canonname[DNS_MAX_NAME_SIZE + 1];
  */
 MODEM_CMD_DEFINE(on_cmd_cdnsgip)
 {
+	struct sim800l_data *mdata = data->user_data;
 	int state;
 	char ips[256];
 	size_t out_len;
@@ -54,18 +60,20 @@ MODEM_CMD_DEFINE(on_cmd_cdnsgip)
 	}
 
 	*ipv4 = '\0';
-	net_addr_pton(dns_result.ai_family, ips,
-		      &((struct sockaddr_in *)&dns_result_addr)->sin_addr);
+	net_addr_pton(mdata->dns.result.ai_family, ips,
+		      &((struct sockaddr_in *)&mdata->dns.result_addr)->sin_addr);
 	ret = 0;
 
 exit:
-	k_sem_give(&mdata.sem_dns);
+	k_sem_give(&mdata->sem_dns);
 	return ret;
 }
 
-/* Response format: <socket_id>, "CONNECT OK" or "CONNECT FAIL" */
-MODEM_CMD_DEFINE(on_cmd_cipstart)
+/* Response format: <socket_id>, "CLOSE OK" or "CLOSE FAIL" */
+MODEM_CMD_DEFINE(on_cmd_cipclose)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	if (argc < 2) {
 		return -EINVAL;
 	}
@@ -78,44 +86,31 @@ MODEM_CMD_DEFINE(on_cmd_cipstart)
 		status++;
 	}
 
-	if (strcmp(status, "CONNECT OK") == 0) {
+	if (strcmp(status, "CLOSE OK") == 0) {
 		modem_cmd_handler_set_error(data, 0);
-	} else if (strcmp(status, "CONNECT FAIL") == 0) {
-		modem_cmd_handler_set_error(data, -ECONNREFUSED);
+	} else if (strcmp(status, "CLOSE FAIL") == 0) {
+		modem_cmd_handler_set_error(data, -EIO);
 	} else {
 		return -ENOMSG; /* not our URC */
 	}
 
-	k_sem_give(&mdata.sem_sock_conn);
-	LOG_DBG("Socket %d connection result: %s", socket_id, status);
+	k_sem_give(&mdata->sem_response);
+	LOG_DBG("Socket %d closed", socket_id);
 	return 0;
 }
 
-/* Response format: <socket_id>, "CLOSE OK" or "CLOSE FAIL" */
-MODEM_CMD_DEFINE(on_cmd_cipclose)
+/* Response format: "SERVER OK" or "SERVER CLOSE" */
+MODEM_CMD_DEFINE(on_cmd_cipserver)
 {
-	if (argc < 2) {
-		return -EINVAL;
-	}
-
-	int socket_id = atoi(argv[0]);
-	char *status = argv[1];
-
-	/* strip leading whitespace */
-	while (*status == ' ') {
-		status++;
-	}
+	struct sim800l_data *mdata = data->user_data;
 
-	if (strcmp(status, "CLOSE OK") == 0) {
+	if (strcmp(argv[0], "OK") == 0) {
 		modem_cmd_handler_set_error(data, 0);
-	} else if (strcmp(status, "CLOSE FAIL") == 0) {
-		modem_cmd_handler_set_error(data, -EIO);
 	} else {
-		return -ENOMSG; /* not our URC */
+		modem_cmd_handler_set_error(data, -EADDRINUSE);
 	}
 
-	k_sem_give(&mdata.sem_response);
-	LOG_DBG("Socket %d closed", socket_id);
+	k_sem_give(&mdata->sem_sock_conn);
 	return 0;
 }
 
@@ -124,30 +119,108 @@ MODEM_CMD_DEFINE(on_cmd_cipclose)
  */
 MODEM_CMD_DIRECT_DEFINE(on_cmd_tx_ready)
 {
+	struct sim800l_data *mdata = data->user_data;
+
 	LOG_DBG("'> ' prompt received");
-	k_sem_give(&mdata.sem_tx_ready);
+	k_sem_give(&mdata->sem_tx_ready);
 	return len;
 }
 
-/* Separate handlers for OK vs FAIL */
-MODEM_CMD_DEFINE(on_cmd_cipsend_ok)
+/*
+ * Give the socket a free modem link. Client and server connections share
+ * the same five links, so the ID is only known once connect or accept runs.
+ */
+static int link_assign(struct sim800l_data *mdata, struct modem_socket *sock, int id)
 {
-	int socket_id = (argc > 0) ? atoi(argv[0]) : 0;
+	int ret = -ENOMEM;
 
-	LOG_DBG("Socket %d: SEND OK", socket_id);
-	modem_cmd_handler_set_error(data, 0);
-	k_sem_give(&mdata.sem_response);
-	return 0;
+	k_mutex_lock(&mdata->link_lock, K_FOREVER);
+
+	for (int i = MDM_BASE_SOCKET_NUM; i < MDM_UNASSIGNED_SOCKET_ID; i++) {
+		if (id >= 0 && i != id) {
+			continue;
+		}
+
+		if (modem_socket_from_id(&mdata->socket_config, i) == NULL &&
+		    !atomic_test_bit(&mdata->closing_links, i)) {
+			ret = modem_socket_id_assign(&mdata->socket_config, sock, i);
+			break;
+		}
+	}
+
+	k_mutex_unlock(&mdata->link_lock);
+
+	return ret;
 }
 
-MODEM_CMD_DEFINE(on_cmd_cipsend_fail)
+static void link_release(struct sim800l_data *mdata, struct modem_socket *sock)
 {
-	int socket_id = (argc > 0) ? atoi(argv[0]) : 0;
+	k_mutex_lock(&mdata->link_lock, K_FOREVER);
+	sock->id = MDM_UNASSIGNED_SOCKET_ID;
+	k_mutex_unlock(&mdata->link_lock);
+}
 
-	LOG_ERR("Socket %d: SEND FAIL", socket_id);
-	modem_cmd_handler_set_error(data, -EIO);
-	k_sem_give(&mdata.sem_response);
-	return 0;
+/*
+ * Close the links marked in closing_links with a quick close. Runs on the
+ * control work queue so close() and the RX thread do not wait for the modem.
+ * A link the modem did not answer for stays marked and is tried again, the
+ * timeouts escalate through the health monitor. Only a reset or AT+CIPSHUT
+ * frees it otherwise, see modem_links_reset().
+ */
+static void link_close_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_data *mdata = CONTAINER_OF(dwork, struct sim800l_data, close_work);
+	char buf[sizeof("AT+CIPCLOSE=#,#")];
+	bool retry = false;
+	int ret;
+
+	static const struct modem_cmd cmd[] = {
+		MODEM_CMD("", on_cmd_cipclose, 2U, ","),
+	};
+
+	for (int i = 0; i < MDM_MAX_SOCKETS; i++) {
+		if (!atomic_test_bit(&mdata->closing_links, i)) {
+			continue;
+		}
+
+		snprintk(buf, sizeof(buf), "AT+CIPCLOSE=%d,1", i);
+		ret = modem_at_cmd(mdata, MDM_AT_CONTROL, cmd, ARRAY_SIZE(cmd), buf);
+		/* ERROR means the link is closed already */
+		if (ret < 0 && ret != -EIO) {
+			LOG_WRN("Failed to close link %d: %d, retrying", i, ret);
+			retry = true;
+			continue;
+		}
+
+		atomic_clear_bit(&mdata->closing_links, i);
+		LOG_DBG("Link %d released", i);
+	}
+
+	if (retry) {
+		k_work_reschedule_for_queue(&mdata->ctl_workq, dwork, MDM_CLOSE_RETRY_DELAY);
+	}
+}
+
+/* Close a link in the background, it stays reserved until the modem answers */
+static void link_close(struct sim800l_data *mdata, int link)
+{
+	atomic_set_bit(&mdata->closing_links, link);
+	k_work_reschedule_for_queue(&mdata->ctl_workq, &mdata->close_work, K_NO_WAIT);
+}
+
+/* Forget the pending closes, the modem closed every link on its own */
+void modem_links_reset(struct sim800l_data *mdata)
+{
+	k_work_cancel_delayable(&mdata->close_work);
+	atomic_clear(&mdata->closing_links);
+}
+
+void modem_links_init(struct sim800l_data *mdata)
+{
+	k_mutex_init(&mdata->link_lock);
+	atomic_clear(&mdata->closing_links);
+	k_work_init_delayable(&mdata->close_work, link_close_work);
 }
 
 static int get_inx_form_fd(struct modem_socket_config *cfg, int sock_fd)
@@ -168,67 +241,264 @@ static int get_inx_form_fd(struct modem_socket_config *cfg, int sock_fd)
 	return -EINVAL;
 }
 
-int modem_offload_socket(int family, int type, int proto)
+int modem_offload_socket(struct sim800l_data *mdata, int family, int type, int proto)
 {
 	int ret;
 
-	ret = modem_socket_get(&mdata.socket_config, family, type, proto);
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	/* The reference is dropped when the socket is closed */
+	ret = modem_lazy_get(mdata);
 	if (ret < 0) {
+		errno = ENETDOWN;
+		return -1;
+	}
+#endif
+
+	ret = modem_socket_get(&mdata->socket_config, family, type, proto);
+	if (ret < 0) {
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+		modem_lazy_put(mdata);
+#endif
 		errno = -ret;
 		return -1;
 	}
 
-	struct modem_socket *sock = modem_socket_from_fd(&mdata.socket_config, ret);
+	struct modem_socket *sock = modem_socket_from_fd(&mdata->socket_config, ret);
 
-	int i = get_inx_form_fd(&mdata.socket_config, ret);
+	int i = get_inx_form_fd(&mdata->socket_config, ret);
 
 	if (i < 0) {
 		LOG_ERR("Failed to get socket index from fd %d", ret);
-		modem_socket_put(&mdata.socket_config, ret);
+		modem_socket_put(&mdata->socket_config, ret);
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+		modem_lazy_put(mdata);
+#endif
 		errno = EINVAL;
 		return -1;
 	}
 
-	struct sim800l_socket_data *sock_data = &mdata.socket_data[i];
-
-	memset(sock_data, 0, sizeof(*sock_data));
-	k_mutex_init(&sock_data->lock);
+	struct sim800l_socket_data *sock_data = &mdata->socket_data[i];
+
+	sock_data->rx_buf = NULL;
+	sock_data->buffered = 0;
+	sock_data->tls_peer_verify = -1;
+	sock_data->rcvtimeo_us = 0;
+	sock_data->sndtimeo_us = 0;
+	sock_data->nonblock = false;
+	sock_data->rcvbuf = MDM_SOCKET_RCVBUF;
+	sock_data->error = 0;
+	sock_data->peer_closed = false;
+	modem_keepalive_default(&sock_data->keepalive);
 	sock->data = sock_data;
+	atomic_inc(&mdata->sockets_used);
 
 	errno = 0;
 	LOG_INF("Created socket: %d", ret);
 	return ret;
 }
 
-static int offload_close(void *obj)
+static void server_reject(struct sim800l_data *mdata, int link)
 {
-	struct modem_socket *sock = (struct modem_socket *)obj;
+	LOG_WRN("Rejecting incoming connection on link %d", link);
+	link_close(mdata, link);
+}
+
+void modem_server_init(struct sim800l_data *mdata)
+{
+	k_msgq_init(&mdata->server.accept_q, mdata->server.accept_q_buf, sizeof(int),
+		    MDM_MAX_SOCKETS);
+	mdata->server.sock = NULL;
+	mdata->server.backlog = MDM_MAX_SOCKETS;
+}
+
+/*
+ * Called from the URC work queue on "<n>, REMOTE IP: <ip>". The connection
+ * gets a socket right away so data received before accept() is kept.
+ */
+void modem_server_incoming(struct sim800l_data *mdata, int link, const char *ip)
+{
+	struct modem_socket *sock;
+	struct sockaddr_in *addr;
+	int fd;
+
+	if (link < 0 || link >= MDM_MAX_SOCKETS) {
+		return;
+	}
+
+	if (!mdata->server.sock ||
+	    k_msgq_num_used_get(&mdata->server.accept_q) >= mdata->server.backlog) {
+		server_reject(mdata, link);
+		return;
+	}
+
+	fd = modem_offload_socket(mdata, AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		server_reject(mdata, link);
+		return;
+	}
+
+	sock = modem_socket_from_fd(&mdata->socket_config, fd);
+	if (link_assign(mdata, sock, link) < 0) {
+		/* Not connected yet, so closing does not talk to the modem */
+		zsock_close(fd);
+		server_reject(mdata, link);
+		return;
+	}
+
+	addr = (struct sockaddr_in *)&sock->dst;
+	addr->sin_family = AF_INET;
+	if (net_addr_pton(AF_INET, ip, &addr->sin_addr) < 0) {
+		LOG_WRN("Malformed remote address %s", ip);
+	}
+
+	sock->src = mdata->server.sock->src;
+	sock->is_connected = true;
+
+	LOG_INF("Incoming connection from %s on link %d, fd %d", ip, link, fd);
+	k_msgq_put(&mdata->server.accept_q, &fd, K_NO_WAIT);
+}
+
+/*
+ * Called from the URC work queue on "<n>, CLOSED". The link is free again right
+ * away, data already received stays with the socket until it is read.
+ */
+void modem_socket_peer_closed(struct sim800l_data *mdata, int link)
+{
+	struct modem_socket *sock;
+	struct sim800l_socket_data *sock_data;
+
+	sock = modem_socket_from_id(&mdata->socket_config, link);
+	if (!sock) {
+		LOG_DBG("Link %d closed without a socket", link);
+		return;
+	}
+
+	LOG_INF("Socket %d closed by peer (link %d)", sock->sock_fd, link);
+
+	sock_data = sock->data;
+	sock_data->peer_closed = true;
+	sock->is_connected = false;
+	link_release(mdata, sock);
+
+	/* Wake readers so they see the end of the stream */
+	k_fifo_cancel_wait(&sock_data->dgram_q);
+	modem_socket_data_ready(&mdata->socket_config, sock);
+}
+
+/*
+ * Called from the URC work queue when received stream data had to be
+ * dropped, over SO_RCVBUF or out of buffers. The link is closed and reads
+ * fail with ECONNRESET once the data before the hole is read.
+ */
+void modem_socket_rx_lost(struct sim800l_data *mdata, int link)
+{
+	struct modem_socket *sock;
+	struct sim800l_socket_data *sock_data;
+
+	sock = modem_socket_from_id(&mdata->socket_config, link);
+	if (!sock || sock->type != SOCK_STREAM) {
+		return;
+	}
+
+	sock_data = sock->data;
+
+	k_mutex_lock(&sock_data->lock, K_FOREVER);
+	if (sock_data->peer_closed) {
+		k_mutex_unlock(&sock_data->lock);
+		return;
+	}
+
+	sock_data->error = ECONNRESET;
+	sock_data->peer_closed = true;
+	k_mutex_unlock(&sock_data->lock);
+
+	LOG_ERR("Socket %d lost received data, resetting link %d", sock->sock_fd, link);
+
+	if (sock->is_connected) {
+		link_close(mdata, link);
+		sock->is_connected = false;
+	}
+	link_release(mdata, sock);
+
+	modem_socket_data_ready(&mdata->socket_config, sock);
+}
+
+/*
+ * Complete the CIPSTART or CIPSEND pending on a link. The status is what
+ * follows "<n>, CONNECT ", "<n>, ALREADY " or "<n>, SEND ". Each socket has
+ * its own completion, so results of different links never mix.
+ */
+void modem_socket_result(struct sim800l_data *mdata, int link, const char *status)
+{
+	struct modem_socket *sock;
+	struct sim800l_socket_data *sock_data;
+
+	sock = modem_socket_from_id(&mdata->socket_config, link);
+	if (!sock) {
+		LOG_DBG("Result %s for link %d without a socket", status, link);
+		return;
+	}
+
+	sock_data = sock->data;
+
+	if (strcmp(status, "OK") == 0) {
+		sock_data->result = 0;
+	} else if (strcmp(status, "CONNECT") == 0) {
+		sock_data->result = -EISCONN;
+	} else {
+		sock_data->result = -EIO;
+	}
+
+	LOG_DBG("Link %d: %s", link, status);
+	k_sem_give(&sock_data->sem_result);
+}
+
+static void server_close(struct sim800l_data *mdata)
+{
+	int fd;
 	int ret;
-	char buf[32];
 
-	static const struct modem_cmd cmd[] = {
-		MODEM_CMD("", on_cmd_cipclose, 2U, ","),
-	};
+	mdata->server.sock = NULL;
+
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+CIPSERVER=0");
+	if (ret < 0) {
+		LOG_WRN("Failed to stop server: %d", ret);
+	}
+
+	/* Connections nobody accepted are closed with the listener */
+	while (k_msgq_get(&mdata->server.accept_q, &fd, K_NO_WAIT) == 0) {
+		if (fd >= 0) {
+			zsock_close(fd);
+		}
+	}
+
+	/* Wake up a pending accept() */
+	fd = -1;
+	k_msgq_put(&mdata->server.accept_q, &fd, K_NO_WAIT);
+}
+
+static int offload_close(void *obj)
+{
+	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_data *mdata;
 
 	if (!sock) {
 		errno = EBADF;
 		return -1;
 	}
 
-	LOG_WRN("offload_close called on socket %d (modem ID: %d), is_connected=%d", sock->sock_fd,
-		sock->id, sock->is_connected);
+	mdata = sock_to_mdata(sock);
+
+	if (sock == mdata->server.sock) {
+		server_close(mdata);
+	}
 
-	/* If socket is connected, send AT+CIPCLOSE to close connection */
+	LOG_DBG("Closing socket %d (link %d), connected %d", sock->sock_fd, sock->id,
+		sock->is_connected);
+
+	/* The fd is released now, the link once the modem confirms the close */
 	if (sock->is_connected) {
-		/* AT+CIPCLOSE=<n>,<socket_id>
-		 * <n> 0 - Slow close, 1 - Quick close
-		 */
-		snprintf(buf, sizeof(buf), "AT+CIPCLOSE=%d", sock->id - MDM_BASE_SOCKET_NUM);
-		ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, cmd, ARRAY_SIZE(cmd),
-				     buf, &mdata.sem_response, MDM_CMD_TIMEOUT);
-		if (ret < 0 || modem_cmd_handler_get_error(&mdata.cmd_handler_data) != 0) {
-			LOG_WRN("Failed to close connection: %d", ret);
-		}
+		link_close(mdata, sock->id - MDM_BASE_SOCKET_NUM);
 		sock->is_connected = false;
 	}
 
@@ -236,35 +506,138 @@ static int offload_close(void *obj)
 	struct sim800l_socket_data *sock_data = sock->data;
 
 	if (sock_data) {
+		struct net_buf *dgram;
+
 		k_mutex_lock(&sock_data->lock, K_FOREVER);
 		if (sock_data->rx_buf) {
 			net_buf_unref(sock_data->rx_buf);
 			sock_data->rx_buf = NULL;
 		}
+		while ((dgram = k_fifo_get(&sock_data->dgram_q, K_NO_WAIT)) != NULL) {
+			net_buf_unref(dgram);
+		}
 		sock_data->buffered = 0;
 		k_mutex_unlock(&sock_data->lock);
 	}
 
 	/* Put socket back to pool */
-	modem_socket_put(&mdata.socket_config, sock->sock_fd);
+	modem_socket_put(&mdata->socket_config, sock->sock_fd);
+	atomic_dec(&mdata->sockets_used);
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	modem_lazy_put(mdata);
+#endif
 
 	errno = 0;
 	return 0;
 }
 
+/*
+ * Switch the modem SSL layer on or off for the next connection. Called with
+ * the AT channel held, the setting is global until the CIPSTART is sent.
+ *
+ * AT+SSLOPT=0,<1|0> ignores or checks the server certificate
+ * AT+CIPSSL=<0|1>
+ */
+static int connect_set_ssl(struct sim800l_data *mdata, struct modem_socket *sock)
+{
+	struct sim800l_socket_data *sock_data = sock->data;
+	bool ssl = sock->ip_proto == IPPROTO_TLS_1_2;
+	char buf[sizeof("AT+SSLOPT=0,#")];
+	int ret;
+
+	if (ssl && sock_data->tls_peer_verify >= 0) {
+		int ignore = sock_data->tls_peer_verify == TLS_PEER_VERIFY_NONE ? 1 : 0;
+
+		if (ignore != mdata->ssl_ignore_cert) {
+			snprintk(buf, sizeof(buf), "AT+SSLOPT=0,%d", ignore);
+			ret = modem_at_exec(mdata, NULL, 0U, buf);
+			if (ret < 0) {
+				LOG_ERR("Failed to set certificate check: %d", ret);
+				return ret;
+			}
+
+			mdata->ssl_ignore_cert = ignore;
+		}
+	}
+
+	if (ssl == mdata->ssl_enabled) {
+		return 0;
+	}
+
+	ret = modem_at_exec(mdata, NULL, 0U, ssl ? "AT+CIPSSL=1" : "AT+CIPSSL=0");
+	if (ret < 0) {
+		LOG_ERR("Failed to %s SSL: %d", ssl ? "enable" : "disable", ret);
+		return ret;
+	}
+
+	mdata->ssl_enabled = ssl;
+	return 0;
+}
+
+/* Modem defaults, also what SO_KEEPALIVE uses without TCP_KEEP* */
+void modem_keepalive_default(struct sim800l_keepalive *ka)
+{
+	ka->enabled = false;
+	ka->idle = 7200;
+	ka->intvl = 75;
+	ka->cnt = 9;
+}
+
+static bool keepalive_equal(const struct sim800l_keepalive *a, const struct sim800l_keepalive *b)
+{
+	if (!a->enabled && !b->enabled) {
+		return true;
+	}
+
+	return a->enabled == b->enabled && a->idle == b->idle && a->intvl == b->intvl &&
+	       a->cnt == b->cnt;
+}
+
+/*
+ * Set up TCP keepalive for the next connection, with the AT channel held.
+ *
+ * AT+CIPTKA=<mode>,<keepIdle>,<keepInterval>,<keepCount>
+ */
+static int connect_set_keepalive(struct sim800l_data *mdata, struct modem_socket *sock)
+{
+	struct sim800l_socket_data *sock_data = sock->data;
+	const struct sim800l_keepalive *ka = &sock_data->keepalive;
+	char buf[sizeof("AT+CIPTKA=#,#####,#####,###")];
+	int ret;
+
+	if (keepalive_equal(ka, &mdata->keepalive)) {
+		return 0;
+	}
+
+	if (ka->enabled) {
+		snprintk(buf, sizeof(buf), "AT+CIPTKA=1,%u,%u,%u", ka->idle, ka->intvl, ka->cnt);
+	} else {
+		snprintk(buf, sizeof(buf), "AT+CIPTKA=0");
+	}
+
+	ret = modem_at_exec(mdata, NULL, 0U, buf);
+	if (ret < 0) {
+		LOG_ERR("Failed to set keepalive: %d", ret);
+		return ret;
+	}
+
+	mdata->keepalive = *ka;
+	return 0;
+}
+
 static int offload_connect(void *obj, const struct sockaddr *addr, socklen_t addrlen)
 {
 	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_data *mdata = sock_to_mdata(sock);
+	struct sim800l_socket_data *sock_data = sock->data;
 	char buf[128];
 	char ip_str[INET_ADDRSTRLEN];
 	uint16_t port;
 	const char *proto;
+	k_timepoint_t deadline = sys_timepoint_calc(modem_rtt_timeout(mdata, MDM_RTT_CONNECT));
+	int64_t start;
 	int ret;
 
-	static const struct modem_cmd cmd[] = {
-		MODEM_CMD("", on_cmd_cipstart, 2U, ","),
-	};
-
 	if (!addr) {
 		errno = EINVAL;
 		return -1;
@@ -278,7 +651,7 @@ static int offload_connect(void *obj, const struct sockaddr *addr, socklen_t add
 
 	const struct sockaddr_in *addr_in = (const struct sockaddr_in *)addr;
 
-	if (modem_socket_is_allocated(&mdata.socket_config, sock) == false) {
+	if (modem_socket_is_allocated(&mdata->socket_config, sock) == false) {
 		LOG_ERR("Invalid socket id %d from fd %d", sock->id, sock->sock_fd);
 		errno = EINVAL;
 		return -1;
@@ -290,6 +663,11 @@ static int offload_connect(void *obj, const struct sockaddr *addr, socklen_t add
 		return -1;
 	}
 
+	if (sock == mdata->server.sock) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
 	/* Extract IP, protocol and port */
 	ret = modem_context_sprint_ip_addr(addr, ip_str, sizeof(ip_str));
 	if (ret < 0) {
@@ -310,54 +688,249 @@ static int offload_connect(void *obj, const struct sockaddr *addr, socklen_t add
 		return -1;
 	}
 
-	LOG_INF("Connecting socket %d to %s:%u via %s", sock->sock_fd, ip_str, port, proto);
+	if (link_assign(mdata, sock, -1) < 0) {
+		LOG_ERR("No free modem link for socket %d", sock->sock_fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	LOG_INF("Connecting socket %d to %s:%u via %s%s", sock->sock_fd, ip_str, port, proto,
+		sock->ip_proto == IPPROTO_TLS_1_2 ? " (SSL)" : "");
 
 	/* Build AT+CIPSTART command */
 	snprintf(buf, sizeof(buf), "AT+CIPSTART=%d,\"%s\",\"%s\",%u", sock->id, proto, ip_str,
 		 port);
 
-	k_sem_reset(&mdata.sem_sock_conn);
+	/* SSL and keepalive are global, keep the channel until CIPSTART is sent */
+	ret = modem_at_acquire(mdata, MDM_AT_CONTROL, deadline);
+	if (ret < 0) {
+		errno = ETIMEDOUT;
+		goto error;
+	}
+
+	if (sock->type == SOCK_STREAM) {
+		ret = connect_set_ssl(mdata, sock);
+		if (ret == 0) {
+			ret = connect_set_keepalive(mdata, sock);
+		}
+	}
 
-	/* Send connect command */
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, NULL, 0U, buf,
-			     &mdata.sem_response, K_SECONDS(1));
+	k_sem_reset(&sock_data->sem_result);
+
+	if (ret == 0) {
+		ret = modem_at_exec(mdata, NULL, 0U, buf);
+	}
+
+	modem_at_release(mdata);
 
 	if (ret < 0) {
 		LOG_ERR("Failed to connect: %d", ret);
 		errno = -ret;
-		return -1;
+		goto error;
 	}
 
-	/* set command handlers */
-	ret = modem_cmd_handler_update_cmds(&mdata.cmd_handler_data, cmd, ARRAY_SIZE(cmd), true);
+	/* The channel is free for others while the link connects */
+	start = k_uptime_get();
+	ret = k_sem_take(&sock_data->sem_result, sys_timepoint_timeout(deadline));
 	if (ret < 0) {
-		LOG_ERR("Failed to set command handlers: %d", ret);
-		errno = -ret;
+		LOG_ERR("Socket connect timeout");
+		modem_rtt_backoff(mdata, MDM_RTT_CONNECT);
+		/* The modem may still be connecting, close the link behind it */
+		link_close(mdata, sock->id - MDM_BASE_SOCKET_NUM);
+		errno = ETIMEDOUT;
+		goto error;
+	}
+
+	modem_rtt_sample(mdata, MDM_RTT_CONNECT, start);
+
+	if (sock_data->result == -EIO) {
+		LOG_ERR("Socket %d connection refused", sock->sock_fd);
+		errno = ECONNREFUSED;
+		goto error;
+	} else if (sock_data->result < 0) {
+		errno = -sock_data->result;
+		goto error;
+	}
+
+	/* Mark socket as connected */
+	sock->is_connected = true;
+	LOG_INF("Socket %d connected successfully", sock->sock_fd);
+	errno = 0;
+	return 0;
+
+error:
+	sock_data->error = errno;
+	link_release(mdata, sock);
+	return -1;
+}
+
+static int offload_bind(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	struct modem_socket *sock = (struct modem_socket *)obj;
+
+	if (!addr || addrlen < sizeof(struct sockaddr_in)) {
+		errno = EINVAL;
 		return -1;
 	}
 
-	/* Wait for CONNECT OK/CONNECT FAIL */
-	ret = k_sem_take(&mdata.sem_sock_conn, MDM_CONN_TIMEOUT);
+	if (addr->sa_family != AF_INET) {
+		errno = EAFNOSUPPORT;
+		return -1;
+	}
+
+	if (sock->is_connected) {
+		errno = EISCONN;
+		return -1;
+	}
+
+	memcpy(&sock->src, addr, sizeof(struct sockaddr_in));
+	errno = 0;
+	return 0;
+}
+
+/*
+ * SO_RCVTIMEO and SO_SNDTIMEO value, O_NONBLOCK and MSG_DONTWAIT override
+ * it
+ */
+static k_timeout_t sock_timeout(const struct sim800l_socket_data *sock_data, uint64_t us,
+				int flags)
+{
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_data->nonblock) {
+		return K_NO_WAIT;
+	}
+
+	return us ? K_USEC(us) : K_FOREVER;
+}
+
+/*
+ * Start the modem TCP server on the port the socket is bound to.
+ *
+ * AT+CIPSERVER=1,<port>
+ * OK
+ * SERVER OK
+ *
+ * Clients are then reported on a free link with "<n>, REMOTE IP: <ip>".
+ * Connections beyond the backlog waiting for accept() are rejected, it is
+ * capped at the number of links.
+ */
+static int offload_listen(void *obj, int backlog)
+{
+	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_data *mdata = sock_to_mdata(sock);
+	char buf[sizeof("AT+CIPSERVER=1,#####")];
+	uint16_t port = ntohs(net_sin(&sock->src)->sin_port);
+	int ret;
+
+	static const struct modem_cmd cmd[] = {
+		MODEM_CMD("SERVER ", on_cmd_cipserver, 1U, ""),
+	};
+
+	if (sock->type != SOCK_STREAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (port == 0U) {
+		LOG_ERR("Socket %d must be bound to a port", sock->sock_fd);
+		errno = EINVAL;
+		return -1;
+	}
+
+	backlog = CLAMP(backlog, 1, MDM_MAX_SOCKETS);
+
+	if (mdata->server.sock == sock) {
+		mdata->server.backlog = backlog;
+		errno = 0;
+		return 0;
+	}
+
+	if (mdata->server.sock) {
+		LOG_ERR("Modem supports a single listening socket");
+		errno = EADDRINUSE;
+		return -1;
+	}
+
+	snprintk(buf, sizeof(buf), "AT+CIPSERVER=1,%u", port);
+
+	/* SERVER OK follows the OK, keep the channel and the handler until then */
+	ret = modem_at_acquire(mdata, MDM_AT_CONTROL, sys_timepoint_calc(MDM_CMD_TIMEOUT));
 	if (ret < 0) {
-		LOG_ERR("Socket connect timeout");
 		errno = ETIMEDOUT;
 		return -1;
 	}
 
-	ret = modem_cmd_handler_get_error(&mdata.cmd_handler_data);
-	if (ret != 0) {
-		LOG_ERR("Socket connect failed: %d", ret);
+	k_sem_reset(&mdata->sem_sock_conn);
+
+	ret = modem_cmd_send_ext(&mdata->ctx.iface, &mdata->ctx.cmd_handler, cmd, ARRAY_SIZE(cmd),
+				 buf, &mdata->sem_response, MDM_CMD_TIMEOUT, MODEM_NO_UNSET_CMDS);
+	if (ret == 0 && k_sem_take(&mdata->sem_sock_conn, MDM_CMD_TIMEOUT) < 0) {
+		LOG_ERR("Server start timeout");
+		ret = -ETIMEDOUT;
+	} else if (ret == 0) {
+		ret = modem_cmd_handler_get_error(&mdata->cmd_handler_data);
+	}
+
+	modem_cmd_handler_update_cmds(&mdata->cmd_handler_data, NULL, 0U, false);
+	modem_at_release(mdata);
+
+	if (ret < 0) {
+		LOG_ERR("Failed to start server: %d", ret);
 		errno = -ret;
 		return -1;
 	}
 
-	/* Mark socket as connected */
-	sock->is_connected = true;
-	LOG_INF("Socket %d connected successfully", sock->sock_fd);
+	k_msgq_purge(&mdata->server.accept_q);
+	mdata->server.backlog = backlog;
+	mdata->server.sock = sock;
+
+	LOG_INF("Listening on port %u", port);
 	errno = 0;
 	return 0;
 }
 
+static int offload_accept(void *obj, struct sockaddr *addr, socklen_t *addrlen)
+{
+	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_data *mdata = sock_to_mdata(sock);
+	struct sim800l_socket_data *sock_data = sock->data;
+	struct modem_socket *new_sock;
+	int fd;
+
+	if (mdata->server.sock != sock) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* SO_RCVTIMEO bounds the wait, O_NONBLOCK only takes a waiting one */
+	if (k_msgq_get(&mdata->server.accept_q, &fd,
+		       sock_timeout(sock_data, sock_data->rcvtimeo_us, 0)) < 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (fd < 0) {
+		/* Listener closed while waiting */
+		errno = ECONNABORTED;
+		return -1;
+	}
+
+	new_sock = modem_socket_from_fd(&mdata->socket_config, fd);
+	if (!new_sock) {
+		errno = ECONNABORTED;
+		return -1;
+	}
+
+	if (addr && addrlen) {
+		socklen_t len = MIN(*addrlen, sizeof(struct sockaddr_in));
+
+		memcpy(addr, &new_sock->dst, len);
+		*addrlen = sizeof(struct sockaddr_in);
+	}
+
+	errno = 0;
+	return fd;
+}
+
 /*
  * Send data over a given socket.
  *
@@ -379,26 +952,27 @@ static ssize_t offload_sendto(void *obj, const void *buf, size_t len, int flags,
 			      const struct sockaddr *dest_addr, socklen_t addrlen)
 {
 	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_data *mdata = sock_to_mdata(sock);
+	struct sim800l_socket_data *sock_data = sock->data;
 	char ctrlz = 0x1A; /* Ctrl+Z character to indicate end of data */
+	k_timeout_t timeout;
 	char cmd[32];
+	int64_t start;
 	int ret;
 
-	/* Only need to catch the '>' prompt - send confirmation handlers are in unsolicited array
-	 */
-	struct modem_cmd handler_cmds[] = {
+	/* Only the '>' prompt, <n>, SEND OK|FAIL completes the socket result */
+	static const struct modem_cmd handler_cmds[] = {
 		MODEM_CMD_DIRECT(">", on_cmd_tx_ready),
-		/* TODO: Currently is a hack to match socket ID, and finish the sending in preoper
-		 * way. This should be improved to properly handle multiple sockets.
-		 */
-		MODEM_CMD("0, SEND OK", on_cmd_cipsend_ok, 0U,
-			  ","), /* Socket: <n>, SEND OK (note leading space) */
-		/* TODO: Not working correctly for multiple sockets */
-		MODEM_CMD("SEND FAIL", on_cmd_cipsend_fail, 1U,
-			  ","), /* Socket: <n>, SEND FAIL (note leading space) */
 	};
 
-	if (!buf || len == 0) {
-		errno = EINVAL;
+	if (!buf || len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Nothing can be sent once the peer closed the link */
+	if (sock_data->peer_closed) {
+		errno = EPIPE;
 		return -1;
 	}
 
@@ -424,56 +998,77 @@ static ssize_t offload_sendto(void *obj, const void *buf, size_t len, int flags,
 	/* Build AT+CIPSEND command with socket ID (multi-IP mode requires socket ID) */
 	snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%d,%zu", sock->id, len);
 
-	/* Reset semaphore before sending */
-	k_sem_take(&mdata.cmd_handler_data.sem_tx_lock, K_FOREVER);
+	/* SO_SNDTIMEO bounds the wait for the AT channel, data goes first */
+	timeout = sock_timeout(sock_data, sock_data->sndtimeo_us, flags);
+	if (modem_at_acquire(mdata, MDM_AT_DATA, sys_timepoint_calc(timeout)) < 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	k_sem_take(&mdata->cmd_handler_data.sem_tx_lock, K_FOREVER);
+
 	/* '>' will give semaphore */
-	k_sem_reset(&mdata.sem_tx_ready);
+	k_sem_reset(&mdata->sem_tx_ready);
+	k_sem_reset(&sock_data->sem_result);
 
-	ret = modem_cmd_send_nolock(&mdata.ctx.iface, &mdata.ctx.cmd_handler, NULL, 0U, cmd, NULL,
+	start = k_uptime_get();
+	ret = modem_cmd_send_nolock(&mdata->ctx.iface, &mdata->ctx.cmd_handler, NULL, 0U, cmd, NULL,
 				    K_NO_WAIT);
 
 	if (ret < 0) {
 		LOG_ERR("Failed to initiate send or get prompt: %d", ret);
-		errno = EIO;
-		return -1;
+		ret = -EIO;
+		goto exit;
 	}
 
 	/* set command handlers */
-	ret = modem_cmd_handler_update_cmds(&mdata.cmd_handler_data, handler_cmds,
+	ret = modem_cmd_handler_update_cmds(&mdata->cmd_handler_data, handler_cmds,
 					    ARRAY_SIZE(handler_cmds), true);
 	if (ret < 0) {
 		LOG_ERR("Failed to set command handlers: %d", ret);
-		errno = EIO;
-		return -1;
+		ret = -EIO;
+		goto exit;
 	}
 
 	/* Wait for '>' */
-	ret = k_sem_take(&mdata.sem_tx_ready, K_SECONDS(2));
+	ret = k_sem_take(&mdata->sem_tx_ready, modem_rtt_timeout(mdata, MDM_RTT_PROMPT));
 	if (ret < 0) {
 		/* Didn't get the data prompt - Exit. */
 		LOG_DBG("Timeout waiting for tx");
-		errno = EIO;
-		return -1;
+		modem_rtt_backoff(mdata, MDM_RTT_PROMPT);
+		ret = -EIO;
+		goto exit;
 	}
 
-	/* Send the actual data */
-	modem_cmd_send_data_nolock(&mdata.ctx.iface, buf, len);
-	modem_cmd_send_data_nolock(&mdata.ctx.iface, &ctrlz, 1);
+	modem_rtt_sample(mdata, MDM_RTT_PROMPT, start);
 
-	/* Wait for 'SEND OK' or 'SEND FAIL' */
-	k_sem_reset(&mdata.sem_response);
-	ret = k_sem_take(&mdata.sem_response, MDM_CMD_TIMEOUT);
+	/* Send the actual data */
+	start = k_uptime_get();
+	modem_cmd_send_data_nolock(&mdata->ctx.iface, buf, len);
+	modem_cmd_send_data_nolock(&mdata->ctx.iface, &ctrlz, 1);
 
-	/* Clean up */
-	modem_cmd_handler_update_cmds(&mdata.cmd_handler_data, NULL, 0U, false);
+	/* Wait for '<n>, SEND OK' or '<n>, SEND FAIL' */
+	ret = k_sem_take(&sock_data->sem_result, modem_rtt_timeout(mdata, MDM_RTT_SEND));
+	if (ret < 0) {
+		LOG_ERR("Timeout waiting for send confirmation");
+		modem_rtt_backoff(mdata, MDM_RTT_SEND);
+		ret = -ETIMEDOUT;
+	} else {
+		modem_rtt_sample(mdata, MDM_RTT_SEND, start);
+		ret = sock_data->result;
+	}
 
-	k_sem_give(&mdata.cmd_handler_data.sem_tx_lock);
+exit:
+	modem_cmd_handler_update_cmds(&mdata->cmd_handler_data, NULL, 0U, false);
+	k_sem_give(&mdata->cmd_handler_data.sem_tx_lock);
+	modem_at_release(mdata);
 
 	if (ret < 0) {
-		LOG_ERR("Timeout waiting for send confirmation");
-		errno = ETIMEDOUT;
+		sock_data->error = -ret;
+		errno = -ret;
 		return -1;
 	}
+
 	LOG_DBG("Successfully sent %zu bytes", len);
 	return (ssize_t)len;
 }
@@ -486,10 +1081,85 @@ static ssize_t offload_write(void *obj, const void *buffer, size_t count)
 	return offload_sendto(obj, buffer, count, 0, NULL, 0);
 }
 
+/*
+ * Return one queued datagram. A datagram larger than the caller's buffer is
+ * truncated and the rest discarded; with MSG_TRUNC the full length is
+ * returned instead of the copied length.
+ */
+static ssize_t recv_datagram(struct modem_socket *sock, void *buf, size_t max_len, int flags,
+			     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct sim800l_socket_data *sock_data = sock->data;
+	struct net_buf *dgram;
+	size_t len;
+	size_t copied;
+
+	dgram = k_fifo_get(&sock_data->dgram_q,
+			   sock_timeout(sock_data, sock_data->rcvtimeo_us, flags));
+	if (!dgram) {
+		if (sock_data->peer_closed) {
+			errno = 0;
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	len = net_buf_frags_len(dgram);
+	copied = net_buf_linearize(buf, max_len, dgram, 0, len);
+
+	if (src_addr && addrlen) {
+		socklen_t copy_len = MIN(*addrlen, sizeof(struct sockaddr_in));
+
+		memcpy(src_addr, net_buf_user_data(dgram), copy_len);
+		*addrlen = sizeof(struct sockaddr_in);
+	}
+
+	k_mutex_lock(&sock_data->lock, K_FOREVER);
+	sock_data->buffered -= MIN(sock_data->buffered, len);
+	k_mutex_unlock(&sock_data->lock);
+
+	net_buf_unref(dgram);
+
+	if (copied < len) {
+		LOG_DBG("Datagram of %zu bytes truncated to %zu on socket %d", len, copied,
+			sock->sock_fd);
+	}
+
+	errno = 0;
+	return (flags & ZSOCK_MSG_TRUNC) ? (ssize_t)len : (ssize_t)copied;
+}
+
+/*
+ * modem_socket_wait_data() with a timeout. The size is checked again once
+ * the socket is marked waiting so data arriving in between is not missed.
+ */
+static int socket_wait_data(struct modem_socket_config *cfg, struct modem_socket *sock,
+			    k_timeout_t timeout)
+{
+	int ret = 0;
+
+	k_sem_take(&cfg->sem_lock, K_FOREVER);
+	sock->is_waiting = true;
+	k_sem_give(&cfg->sem_lock);
+
+	if (modem_socket_next_packet_size(cfg, sock) == 0U) {
+		ret = k_sem_take(&sock->sem_data_ready, timeout);
+	}
+
+	k_sem_take(&cfg->sem_lock, K_FOREVER);
+	sock->is_waiting = false;
+	k_sem_give(&cfg->sem_lock);
+
+	return ret;
+}
+
 static ssize_t offload_recvfrom(void *obj, void *buf, size_t max_len, int flags,
 				struct sockaddr *src_addr, socklen_t *addrlen)
 {
 	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_data *mdata;
 	size_t total_read = 0;
 	int ret;
 
@@ -498,28 +1168,22 @@ static ssize_t offload_recvfrom(void *obj, void *buf, size_t max_len, int flags,
 		return -1;
 	}
 
+	mdata = sock_to_mdata(sock);
+
 	if (flags & ZSOCK_MSG_PEEK) {
 		errno = ENOTSUP;
 		return -1;
 	}
 
-	if (flags & ~(ZSOCK_MSG_DONTWAIT)) {
+	if (flags & ~(ZSOCK_MSG_DONTWAIT | ZSOCK_MSG_TRUNC)) {
 		errno = ENOTSUP;
 		return -1;
 	}
 
-	if (!(flags & ZSOCK_MSG_DONTWAIT)) {
-		modem_socket_wait_data(&mdata.socket_config, sock);
-	}
-
-	uint16_t available = modem_socket_next_packet_size(&mdata.socket_config, sock);
-
-	if (available == 0U) {
-		errno = EAGAIN;
-		return -1;
+	if (sock->type == SOCK_DGRAM) {
+		return recv_datagram(sock, buf, max_len, flags, src_addr, addrlen);
 	}
 
-	size_t to_read = MIN((size_t)available, max_len);
 	struct sim800l_socket_data *sock_data = sock->data;
 
 	if (!sock_data) {
@@ -528,6 +1192,34 @@ static ssize_t offload_recvfrom(void *obj, void *buf, size_t max_len, int flags,
 		return -1;
 	}
 
+	/* Only block when nothing is buffered yet, SO_RCVTIMEO bounds the wait */
+	if (!(flags & ZSOCK_MSG_DONTWAIT) && !sock_data->peer_closed &&
+	    modem_socket_next_packet_size(&mdata->socket_config, sock) == 0U) {
+		socket_wait_data(&mdata->socket_config, sock,
+				 sock_timeout(sock_data, sock_data->rcvtimeo_us, flags));
+	}
+
+	uint16_t available = modem_socket_next_packet_size(&mdata->socket_config, sock);
+
+	if (available == 0U) {
+		if (sock_data->peer_closed && sock_data->error) {
+			/* Reset after received data was lost */
+			errno = sock_data->error;
+			return -1;
+		}
+
+		if (sock_data->peer_closed) {
+			/* End of stream */
+			errno = 0;
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	size_t to_read = MIN((size_t)available, max_len);
+
 	k_mutex_lock(&sock_data->lock, K_FOREVER);
 
 	if (!sock_data->rx_buf || sock_data->buffered == 0) {
@@ -551,19 +1243,15 @@ static ssize_t offload_recvfrom(void *obj, void *buf, size_t max_len, int flags,
 	}
 
 	total_read = copied;
-	net_buf_pull(sock_data->rx_buf, total_read);
+	/* Drained fragments are freed, NULL once everything is read */
+	sock_data->rx_buf = net_buf_skip(sock_data->rx_buf, total_read);
 	if (sock_data->buffered >= total_read) {
 		sock_data->buffered -= total_read;
 	} else {
 		sock_data->buffered = 0;
 	}
 
-	if (sock_data->rx_buf->len == 0 && sock_data->rx_buf->frags == NULL) {
-		net_buf_unref(sock_data->rx_buf);
-		sock_data->rx_buf = NULL;
-	}
-
-	ret = modem_socket_packet_size_update(&mdata.socket_config, sock, -(int)total_read);
+	ret = modem_socket_packet_size_update(&mdata->socket_config, sock, -(int)total_read);
 	if (ret < 0) {
 		LOG_WRN("Failed to update packet size for socket %d: %d", sock->id, ret);
 	}
@@ -577,9 +1265,9 @@ static ssize_t offload_recvfrom(void *obj, void *buf, size_t max_len, int flags,
 		*addrlen = (socklen_t)copy_len;
 	}
 
-	if (modem_socket_next_packet_size(&mdata.socket_config, sock) > 0) {
+	if (modem_socket_next_packet_size(&mdata->socket_config, sock) > 0) {
 		/* More data pending */
-		modem_socket_data_ready(&mdata.socket_config, sock);
+		modem_socket_data_ready(&mdata->socket_config, sock);
 	}
 
 	LOG_DBG("Received %zu bytes on socket %d (modem ID: %d)", total_read, sock->sock_fd,
@@ -650,34 +1338,316 @@ static ssize_t offload_sendmsg(void *obj, const struct msghdr *msg, int flags)
 	return sent;
 }
 
+/*
+ * TLS options for IPPROTO_TLS_1_2 sockets. The handshake runs on the modem,
+ * which holds its own certificates, so only the peer check can be tuned.
+ */
+static int tls_setsockopt(struct modem_socket *sock, int optname, const void *optval,
+			  socklen_t optlen)
+{
+	struct sim800l_socket_data *sock_data = sock->data;
+
+	if (sock->ip_proto != IPPROTO_TLS_1_2) {
+		return -ENOPROTOOPT;
+	}
+
+	switch (optname) {
+	case TLS_PEER_VERIFY:
+		if (!optval || optlen != sizeof(int)) {
+			return -EINVAL;
+		}
+
+		sock_data->tls_peer_verify = *(const int *)optval;
+		break;
+	case TLS_HOSTNAME:
+		/* No SNI on the modem, the name is not needed for the handshake */
+		LOG_DBG("Ignoring TLS hostname on socket %d", sock->sock_fd);
+		break;
+	case TLS_SEC_TAG_LIST:
+		/* Credentials are provisioned on the modem, not per socket */
+		if (optlen > 0) {
+			LOG_WRN("Security tags are not supported, using modem certificates");
+		}
+		break;
+	default:
+		return -ENOPROTOOPT;
+	}
+
+	return 0;
+}
+
+static int timeval_to_us(const void *optval, socklen_t optlen, uint64_t *us)
+{
+	const struct zsock_timeval *tv = optval;
+
+	if (!optval || optlen != sizeof(*tv) || tv->tv_sec < 0 || tv->tv_usec < 0) {
+		return -EINVAL;
+	}
+
+	*us = (uint64_t)tv->tv_sec * USEC_PER_SEC + tv->tv_usec;
+	return 0;
+}
+
+/*
+ * SO_BINDTODEVICE. A socket lives on the modem it was created on, so only
+ * the interface of that modem is accepted. The socket dispatcher creates
+ * the socket on the named interface before it passes the option on.
+ */
+static int bind_to_device(struct modem_socket *sock, const void *optval, socklen_t optlen)
+{
+	const struct ifreq *ifreq = optval;
+	struct net_if *iface;
+
+	if (!ifreq || optlen != sizeof(*ifreq)) {
+		return -EINVAL;
+	}
+
+	/* An empty name removes the binding, nothing to do */
+	if (ifreq->ifr_name[0] == '\0') {
+		return 0;
+	}
+
+#ifdef CONFIG_NET_INTERFACE_NAME
+	int index = net_if_get_by_name(ifreq->ifr_name);
+
+	iface = index > 0 ? net_if_get_by_index(index) : NULL;
+#else
+	iface = net_if_lookup_by_dev(device_get_binding(ifreq->ifr_name));
+#endif
+	if (!iface) {
+		return -ENODEV;
+	}
+
+	return iface == sock_to_mdata(sock)->netif ? 0 : -EINVAL;
+}
+
+static int sol_socket_setsockopt(struct modem_socket *sock, int optname, const void *optval,
+				 socklen_t optlen)
+{
+	struct sim800l_socket_data *sock_data = sock->data;
+	int val;
+
+	switch (optname) {
+	case SO_RCVTIMEO:
+		return timeval_to_us(optval, optlen, &sock_data->rcvtimeo_us);
+	case SO_SNDTIMEO:
+		return timeval_to_us(optval, optlen, &sock_data->sndtimeo_us);
+	case SO_BINDTODEVICE:
+		return bind_to_device(sock, optval, optlen);
+	default:
+		break;
+	}
+
+	if (!optval || optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	val = *(const int *)optval;
+
+	switch (optname) {
+	case SO_RCVBUF:
+		if (val <= 0) {
+			return -EINVAL;
+		}
+
+		sock_data->rcvbuf = MIN((size_t)val, MDM_RECV_MAX_BUF * MDM_RECV_BUF_SIZE);
+		return 0;
+	case SO_KEEPALIVE:
+		if (sock->type != SOCK_STREAM) {
+			return -ENOPROTOOPT;
+		}
+
+		sock_data->keepalive.enabled = val != 0;
+		if (sock->is_connected) {
+			LOG_WRN("Keepalive applies to the next connection of socket %d",
+				sock->sock_fd);
+		}
+		return 0;
+	default:
+		return -ENOPROTOOPT;
+	}
+}
+
+/* Keepalive parameters, clamped to the AT+CIPTKA ranges */
+static int tcp_setsockopt(struct modem_socket *sock, int optname, const void *optval,
+			  socklen_t optlen)
+{
+	struct sim800l_socket_data *sock_data = sock->data;
+	int val;
+
+	if (sock->type != SOCK_STREAM) {
+		return -ENOPROTOOPT;
+	}
+
+	if (!optval || optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	val = *(const int *)optval;
+
+	switch (optname) {
+	case TCP_KEEPIDLE:
+		sock_data->keepalive.idle = CLAMP(val, 30, 7200);
+		break;
+	case TCP_KEEPINTVL:
+		sock_data->keepalive.intvl = CLAMP(val, 30, 600);
+		break;
+	case TCP_KEEPCNT:
+		sock_data->keepalive.cnt = CLAMP(val, 1, 9);
+		break;
+	default:
+		return -ENOPROTOOPT;
+	}
+
+	return 0;
+}
+
+static int offload_setsockopt(void *obj, int level, int optname, const void *optval,
+			      socklen_t optlen)
+{
+	struct modem_socket *sock = (struct modem_socket *)obj;
+	int ret;
+
+	switch (level) {
+	case SOL_TLS:
+		ret = tls_setsockopt(sock, optname, optval, optlen);
+		break;
+	case SOL_SOCKET:
+		ret = sol_socket_setsockopt(sock, optname, optval, optlen);
+		break;
+	case IPPROTO_TCP:
+		ret = tcp_setsockopt(sock, optname, optval, optlen);
+		break;
+	default:
+		ret = -ENOPROTOOPT;
+		break;
+	}
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	errno = 0;
+	return 0;
+}
+
+static int offload_getsockopt(void *obj, int level, int optname, void *optval, socklen_t *optlen)
+{
+	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_socket_data *sock_data = sock->data;
+	uint64_t us;
+	int val;
+
+	if (!optval || !optlen) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (level != SOL_SOCKET) {
+		errno = ENOPROTOOPT;
+		return -1;
+	}
+
+	switch (optname) {
+	case SO_RCVTIMEO:
+	case SO_SNDTIMEO: {
+		struct zsock_timeval *tv = optval;
+
+		if (*optlen < sizeof(*tv)) {
+			errno = EINVAL;
+			return -1;
+		}
+
+		us = optname == SO_RCVTIMEO ? sock_data->rcvtimeo_us : sock_data->sndtimeo_us;
+		tv->tv_sec = us / USEC_PER_SEC;
+		tv->tv_usec = us % USEC_PER_SEC;
+		*optlen = sizeof(*tv);
+		errno = 0;
+		return 0;
+	}
+	case SO_RCVBUF:
+		val = sock_data->rcvbuf;
+		break;
+	case SO_ERROR:
+		val = sock_data->error;
+		sock_data->error = 0;
+		break;
+	case SO_KEEPALIVE:
+		val = sock_data->keepalive.enabled ? 1 : 0;
+		break;
+	case SO_TYPE:
+		val = sock->type;
+		break;
+	default:
+		errno = ENOPROTOOPT;
+		return -1;
+	}
+
+	if (*optlen < sizeof(int)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	*(int *)optval = val;
+	*optlen = sizeof(int);
+	errno = 0;
+	return 0;
+}
+
 /*
  * Perform a dns lookup.
  */
+static struct sim800l_data *dns_instance(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+		if (instances[i] && instances[i]->state == SIM800L_STATE_READY) {
+			return instances[i];
+		}
+	}
+
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	/* None up yet, the lookup brings the first one up */
+	return instances[0];
+#else
+	return NULL;
+#endif
+}
+
 static int offload_getaddrinfo(const char *node, const char *service,
 			       const struct zsock_addrinfo *hints, struct zsock_addrinfo **res)
 {
 	struct modem_cmd cmd[] = {MODEM_CMD("+CDNSGIP: ", on_cmd_cdnsgip, 2U, ",")};
 	char sendbuf[sizeof("AT+CDNSGIP=\"\",##,#####") + 128];
+	struct sim800l_data *mdata;
+	struct zsock_addrinfo *result;
+	struct sockaddr *result_addr;
 	uint32_t port = 0;
+	k_timeout_t timeout;
+	int64_t start;
 	int ret;
 
-	/* Modem is not attached to the network. */
-	if (mdata.state != SIM800L_STATE_READY) {
+	/* Lookups go through the first modem attached to the network. */
+	mdata = dns_instance();
+	if (!mdata) {
 		LOG_ERR("Modem currently not attached to the network!");
 		return DNS_EAI_AGAIN;
 	}
 
+	result = &mdata->dns.result;
+	result_addr = &mdata->dns.result_addr;
+
 	/* init result */
-	(void)memset(&dns_result, 0, sizeof(dns_result));
-	(void)memset(&dns_result_addr, 0, sizeof(dns_result_addr));
+	(void)memset(result, 0, sizeof(*result));
+	(void)memset(result_addr, 0, sizeof(*result_addr));
 
 	/* Currently only support IPv4. */
-	dns_result.ai_family = AF_INET;
-	dns_result_addr.sa_family = AF_INET;
-	dns_result.ai_addr = &dns_result_addr;
-	dns_result.ai_addrlen = sizeof(dns_result_addr);
-	dns_result.ai_canonname = dns_result_canonname;
-	dns_result_canonname[0] = '\0';
+	result->ai_family = AF_INET;
+	result_addr->sa_family = AF_INET;
+	result->ai_addr = result_addr;
+	result->ai_addrlen = sizeof(*result_addr);
+	result->ai_canonname = mdata->dns.result_canonname;
+	mdata->dns.result_canonname[0] = '\0';
 
 	if (service) {
 		port = atoi(service);
@@ -687,15 +1657,15 @@ static int offload_getaddrinfo(const char *node, const char *service,
 	}
 
 	if (port > 0U) {
-		if (dns_result.ai_family == AF_INET) {
-			net_sin(&dns_result_addr)->sin_port = htons(port);
+		if (result->ai_family == AF_INET) {
+			net_sin(result_addr)->sin_port = htons(port);
 		}
 	}
 
 	/* Check if node is an IP address */
-	if (net_addr_pton(dns_result.ai_family, node,
-			  &((struct sockaddr_in *)&dns_result_addr)->sin_addr) == 0) {
-		*res = &dns_result;
+	if (net_addr_pton(result->ai_family, node,
+			  &((struct sockaddr_in *)result_addr)->sin_addr) == 0) {
+		*res = result;
 		return 0;
 	}
 
@@ -704,20 +1674,47 @@ static int offload_getaddrinfo(const char *node, const char *service,
 		return DNS_EAI_NONAME;
 	}
 
-	ret = snprintk(sendbuf, sizeof(sendbuf), "AT+CDNSGIP=\"%s\",%u,%u", node, mdata.dns.recount,
-		       mdata.dns.timeout);
+	ret = snprintk(sendbuf, sizeof(sendbuf), "AT+CDNSGIP=\"%s\",%u,%u", node,
+		       mdata->dns.recount, mdata->dns.timeout);
 	if (ret < 0) {
 		LOG_ERR("Formatting dns query failed");
 		return ret;
 	}
 
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, cmd, ARRAY_SIZE(cmd),
-			     sendbuf, &mdata.sem_dns, MDM_DNS_TIMEOUT);
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	if (modem_lazy_get(mdata) < 0) {
+		return DNS_EAI_AGAIN;
+	}
+#endif
+
+	/* +CDNSGIP follows the OK, keep the channel until it arrives */
+	timeout = modem_rtt_timeout(mdata, MDM_RTT_DNS);
+	ret = modem_at_acquire(mdata, MDM_AT_CONTROL, sys_timepoint_calc(timeout));
+	if (ret < 0) {
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+		modem_lazy_put(mdata);
+#endif
+		return DNS_EAI_AGAIN;
+	}
+
+	start = k_uptime_get();
+	ret = modem_cmd_send(&mdata->ctx.iface, &mdata->ctx.cmd_handler, cmd, ARRAY_SIZE(cmd),
+			     sendbuf, &mdata->sem_dns, timeout);
+	if (ret == -ETIMEDOUT) {
+		modem_rtt_backoff(mdata, MDM_RTT_DNS);
+	} else {
+		modem_rtt_sample(mdata, MDM_RTT_DNS, start);
+	}
+
+	modem_at_release(mdata);
+#ifdef CONFIG_MODEM_SIM800L_LAZY
+	modem_lazy_put(mdata);
+#endif
 	if (ret < 0) {
 		return ret;
 	}
 
-	*res = (struct zsock_addrinfo *)&dns_result;
+	*res = result;
 	return 0;
 }
 
@@ -738,17 +1735,27 @@ const struct socket_dns_offload offload_dns_ops = {
 	.freeaddrinfo = offload_freeaddrinfo,
 };
 
+/* fcntl() O_NONBLOCK, nothing else is supported */
 static int offload_ioctl(void *obj, unsigned int request, va_list args)
 {
-	ARG_UNUSED(obj);
-	ARG_UNUSED(request);
-	ARG_UNUSED(args);
+	struct modem_socket *sock = (struct modem_socket *)obj;
+	struct sim800l_socket_data *sock_data = sock->data;
 
-	errno = ENOTSUP;
-	return 0;
+	switch (request) {
+	case ZVFS_F_GETFL:
+		return sock_data->nonblock ? ZVFS_O_NONBLOCK : 0;
+
+	case ZVFS_F_SETFL:
+		sock_data->nonblock = (va_arg(args, int) & ZVFS_O_NONBLOCK) != 0;
+		return 0;
+
+	default:
+		errno = ENOTSUP;
+		return 0;
+	}
 }
 
-bool modem_offload_is_supported(int family, int type, int proto)
+static bool offload_is_supported(int family, int type, int proto)
 {
 	if (family != AF_INET && family != AF_INET6) {
 		return false;
@@ -758,13 +1765,53 @@ bool modem_offload_is_supported(int family, int type, int proto)
 		return false;
 	}
 
-	if (proto != IPPROTO_TCP && proto != IPPROTO_UDP) {
+	if (proto != IPPROTO_TCP && proto != IPPROTO_UDP && proto != IPPROTO_TLS_1_2) {
+		return false;
+	}
+
+	/* TLS is only available over TCP */
+	if (proto == IPPROTO_TLS_1_2 && type != SOCK_STREAM) {
 		return false;
 	}
 
 	return true;
 }
 
+/*
+ * Sockets created without SO_BINDTODEVICE go to the registered modem with
+ * the fewest open sockets, or to the first one while none is up.
+ */
+static int offload_socket_any(int family, int type, int proto)
+{
+	struct sim800l_data *best = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+		struct sim800l_data *mdata = instances[i];
+
+		if (!mdata || mdata->state != SIM800L_STATE_READY) {
+			continue;
+		}
+
+		if (!best || atomic_get(&mdata->sockets_used) < atomic_get(&best->sockets_used)) {
+			best = mdata;
+		}
+	}
+
+	if (!best) {
+		best = instances[0];
+	}
+
+	if (!best) {
+		errno = ENETDOWN;
+		return -1;
+	}
+
+	return modem_offload_socket(best, family, type, proto);
+}
+
+NET_SOCKET_OFFLOAD_REGISTER(simcom_sim800l, CONFIG_NET_SOCKETS_OFFLOAD_PRIORITY, AF_UNSPEC,
+			    offload_is_supported, offload_socket_any);
+
 static inline uint32_t hash32(char *str, int len)
 {
 #define HASH_MULTIPLIER 37
@@ -802,27 +1849,48 @@ const struct socket_op_vtable offload_socket_fd_op_vtable = {
 			.close = offload_close,
 			.ioctl = offload_ioctl,
 		},
-	.bind = NULL,
+	.bind = offload_bind,
 	.connect = offload_connect,
 	.sendto = offload_sendto,
 	.recvfrom = offload_recvfrom,
-	.listen = NULL,
-	.accept = NULL,
+	.listen = offload_listen,
+	.accept = offload_accept,
 	.sendmsg = offload_sendmsg,
-	.getsockopt = NULL,
-	.setsockopt = NULL,
+	.getsockopt = offload_getsockopt,
+	.setsockopt = offload_setsockopt,
 };
 
 /* Setup the Modem NET Interface. */
 void modem_net_iface_init(struct net_if *iface)
 {
 	const struct device *dev = net_if_get_device(iface);
+	const struct sim800l_config *config = dev->config;
+	struct sim800l_data *mdata = dev->data;
+	bool first = true;
+
+	net_if_set_link_addr(iface, modem_get_mac(dev), sizeof(mdata->mac_addr),
+			     NET_LINK_ETHERNET);
+
+	mdata->netif = iface;
+
+	/* Dormant until registered, attached and the PDP context is up */
+	net_if_dormant_on(iface);
+	modem_link_update(mdata);
 
-	net_if_set_link_addr(iface, modem_get_mac(dev), sizeof(mdata.mac_addr), NET_LINK_ETHERNET);
+	for (int i = 0; i < ARRAY_SIZE(instances); i++) {
+		if (instances[i]) {
+			first = false;
+			continue;
+		}
 
-	mdata.netif = iface;
+		instances[i] = mdata;
+		break;
+	}
 
-	socket_offload_dns_register(&offload_dns_ops);
+	/* DNS offload is global, register it only once */
+	if (first) {
+		socket_offload_dns_register(&offload_dns_ops);
+	}
 
-	net_if_socket_offload_set(iface, modem_offload_socket);
+	net_if_socket_offload_set(iface, config->socket_create);
 }
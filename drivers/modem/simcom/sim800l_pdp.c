@@ -5,10 +5,15 @@
  *
  */
 
+#include <string.h>
+
 #include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
 #include <zephyr/net/offloaded_netdev.h>
 #include <zephyr/net/socket_offload.h>
 
+#include <drivers/sim800l.h>
+
 #include "sim800l.h"
 
 LOG_MODULE_REGISTER(modem_simcom_sim800l_pdp, CONFIG_MODEM_SIM800L_LOG_LEVEL);
@@ -19,25 +24,25 @@ LOG_MODULE_REGISTER(modem_simcom_sim800l_pdp, CONFIG_MODEM_SIM800L_LOG_LEVEL);
  */
 MODEM_CMD_DEFINE(on_cmd_cifsr)
 {
-
+	struct sim800l_data *mdata = data->user_data;
 	size_t out_len;
 
 	/* Extract IP address from response */
-	out_len = net_buf_linearize(mdata.ip_addr, sizeof(mdata.ip_addr) - 1, data->rx_buf, 0, len);
-	mdata.ip_addr[out_len] = '\0';
+	out_len =
+		net_buf_linearize(mdata->ip_addr, sizeof(mdata->ip_addr) - 1, data->rx_buf, 0, len);
+	mdata->ip_addr[out_len] = '\0';
 
 	/* Remove any trailing whitespace or newlines */
 	while (out_len > 0 &&
-	       (mdata.ip_addr[out_len - 1] == '\r' || mdata.ip_addr[out_len - 1] == '\n' ||
-		mdata.ip_addr[out_len - 1] == ' ')) {
-		mdata.ip_addr[--out_len] = '\0';
+	       (mdata->ip_addr[out_len - 1] == '\r' || mdata->ip_addr[out_len - 1] == '\n' ||
+		mdata->ip_addr[out_len - 1] == ' ')) {
+		mdata->ip_addr[--out_len] = '\0';
 	}
 
-	LOG_INF("Local IP address: %s", mdata.ip_addr);
+	LOG_INF("Local IP address: %s", mdata->ip_addr);
 
-	/* TODO: Set the IP address on the network interface */
-	/* This would involve parsing the IP and calling net_if_ipv4_addr_add() */
-	k_sem_give(&mdata.sem_response);
+	/* The interface gets the address once the link is up, see link_work() */
+	k_sem_give(&mdata->sem_response);
 	return 0;
 }
 
@@ -46,122 +51,368 @@ MODEM_CMD_DEFINE(on_cmd_cifsr)
  */
 MODEM_CMD_DEFINE(on_cmd_cgatt)
 {
+	struct sim800l_data *mdata = data->user_data;
 	int cgatt = atoi(argv[0]);
 
 	if (cgatt) {
-		mdata.status_flags |= SIM800L_STATUS_FLAG_ATTACHED;
+		mdata->status_flags |= SIM800L_STATUS_FLAG_ATTACHED;
 	} else {
-		mdata.status_flags &= ~SIM800L_STATUS_FLAG_ATTACHED;
+		mdata->status_flags &= ~SIM800L_STATUS_FLAG_ATTACHED;
 	}
 
 	LOG_INF("CGATT: %d", cgatt);
+	modem_link_update(mdata);
 	return 0;
 }
 
 /*
- * Parses the non urc C(E)REG and updates registration status.
+ * Handler for the operator query.
+ * +COPS: <mode>[,<format>,"<oper>"], numeric format set at boot
  */
-MODEM_CMD_DEFINE(on_cmd_cereg)
+MODEM_CMD_DEFINE(on_cmd_cops)
 {
-	mdata.network_registration = atoi(argv[1]);
-	LOG_INF("CREG: %u", mdata.network_registration);
+	struct sim800l_data *mdata = data->user_data;
+	char oper[MDM_OPERATOR_LENGTH] = "";
+	size_t oper_len;
+
+	if (argc >= 3 && atoi(argv[1]) == 2) {
+		oper_len = strlen(argv[2]);
+		if (oper_len >= 2 && argv[2][0] == '"' && argv[2][oper_len - 1] == '"' &&
+		    oper_len - 2 < sizeof(oper)) {
+			memcpy(oper, argv[2] + 1, oper_len - 2);
+			oper[oper_len - 2] = '\0';
+		}
+	}
+
+	if (oper[0] == '\0' || strcmp(oper, mdata->network.oper) == 0) {
+		return 0;
+	}
+
+	LOG_INF("Serving operator %s", oper);
+	strcpy(mdata->network.oper, oper);
+	strcpy(mdata->network.imsi, mdata->imsi);
+#ifdef CONFIG_MODEM_SIM800L_SETTINGS
+	modem_settings_save_network(mdata);
+#endif
 	return 0;
 }
 
-int modem_pdp_activate(void)
+MODEM_CMD_DEFINE(on_cmd_shut_ok)
+{
+	struct sim800l_data *mdata = data->user_data;
+
+	modem_cmd_handler_set_error(data, 0);
+	k_sem_give(&mdata->sem_response);
+	return 0;
+}
+
+static bool modem_link_ready(struct sim800l_data *mdata)
+{
+	uint32_t flags = SIM800L_STATUS_FLAG_ATTACHED | SIM800L_STATUS_FLAG_PDP_ACTIVE;
+
+	return (mdata->network_registration == 1 || mdata->network_registration == 5) &&
+	       (mdata->status_flags & flags) == flags;
+}
+
+/*
+ * Follow registration, attach and PDP state on the interface. It is dormant
+ * while any of them is missing, the connection manager turns the operational
+ * state changes into L4 connected and disconnected events.
+ */
+static void link_work(struct k_work *work)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(work, struct sim800l_data, link.work);
+	bool up = modem_link_ready(mdata);
+
+	if (!mdata->netif || up == mdata->link.up) {
+		return;
+	}
+
+	mdata->link.up = up;
+
+	if (up) {
+#ifdef CONFIG_NET_IPV4
+		if (net_addr_pton(AF_INET, mdata->ip_addr, &mdata->link.addr) == 0) {
+			net_if_ipv4_addr_add(mdata->netif, &mdata->link.addr, NET_ADDR_MANUAL, 0);
+		}
+#endif
+		net_if_dormant_off(mdata->netif);
+	} else {
+		net_if_dormant_on(mdata->netif);
+#ifdef CONFIG_NET_IPV4
+		if (mdata->link.addr.s_addr != 0) {
+			net_if_ipv4_addr_rm(mdata->netif, &mdata->link.addr);
+			mdata->link.addr.s_addr = 0;
+		}
+#endif
+	}
+
+	LOG_INF("Link %s", up ? "up" : "down");
+
+#ifdef CONFIG_MODEM_SIM800L_CONN_MGR
+	modem_conn_link_changed(mdata, up);
+#endif
+}
+
+void modem_link_init(struct sim800l_data *mdata)
+{
+	k_work_init(&mdata->link.work, link_work);
+}
+
+/* Safe to call from the response handlers, the interface is updated from a work item */
+void modem_link_update(struct sim800l_data *mdata)
+{
+	k_work_submit(&mdata->link.work);
+}
+
+/*
+ * The +CREG: response is handled by the unsolicited handler, which updates
+ * the registration status.
+ */
+int modem_query_registration(struct sim800l_data *mdata, enum modem_at_class cls)
+{
+	int ret;
+
+	ret = modem_at_cmd(mdata, cls, NULL, 0U, "AT+CREG?");
+	if (ret < 0) {
+		LOG_ERR("Failed to query registration.");
+	}
+
+	return ret;
+}
+
+int modem_query_attach(struct sim800l_data *mdata, enum modem_at_class cls)
+{
+	const struct modem_cmd cmd[] = {MODEM_CMD("+CGATT: ", on_cmd_cgatt, 1U, "")};
+	int ret;
+
+	ret = modem_at_cmd(mdata, cls, cmd, ARRAY_SIZE(cmd), "AT+CGATT?");
+	if (ret < 0) {
+		LOG_ERR("Failed to query cgatt.");
+	}
+
+	return ret;
+}
+
+/*
+ * Start the registration on the operator that served the SIM last time,
+ * falling back to automatic selection when it is not available.
+ */
+void modem_operator_hint(struct sim800l_data *mdata)
+{
+	char cmd[32];
+	int ret;
+
+	if (mdata->network.oper[0] == '\0') {
+		return;
+	}
+
+	/* Another SIM, the last operator says nothing about it */
+	if (strcmp(mdata->network.imsi, mdata->imsi) != 0) {
+		mdata->network.oper[0] = '\0';
+		return;
+	}
+
+	LOG_DBG("Registering on last operator %s", mdata->network.oper);
+
+	snprintk(cmd, sizeof(cmd), "AT+COPS=4,2,\"%s\"", mdata->network.oper);
+	ret = modem_at_send(mdata, MDM_AT_CONTROL, NULL, 0U, cmd, MDM_REGISTRATION_TIMEOUT);
+	if (ret < 0) {
+		LOG_WRN("Operator hint failed: %d", ret);
+	}
+}
+
+/* Remember the serving operator for the next boot */
+void modem_operator_update(struct sim800l_data *mdata)
+{
+	const struct modem_cmd cmd[] = {MODEM_CMD_ARGS_MAX("+COPS: ", on_cmd_cops, 1U, 3U, ",")};
+	int ret;
+
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, cmd, ARRAY_SIZE(cmd), "AT+COPS?");
+	if (ret < 0) {
+		LOG_WRN("Failed to query operator: %d", ret);
+	}
+}
+
+int sim800l_set_apn(const struct device *dev, const char *apn)
+{
+	struct sim800l_data *mdata = dev->data;
+
+	if (!apn || strlen(apn) >= sizeof(mdata->apn) || strchr(apn, '"')) {
+		return -EINVAL;
+	}
+
+	strcpy(mdata->apn, apn);
+#ifdef CONFIG_MODEM_SIM800L_SETTINGS
+	modem_settings_save(mdata, "apn");
+#endif
+
+	return 0;
+}
+
+int modem_pdp_activate(struct sim800l_data *mdata)
 {
 	/* PDP activation not implemented for SIM800L */
 	int ret = 0;
 	int counter = 0;
-	const char *buf = "AT+CREG?";
-	struct modem_cmd cmds[] = {MODEM_CMD("+CREG: ", on_cmd_cereg, 2U, ",")};
 
 	const struct modem_cmd cifsr_cmd[] = {
 		MODEM_CMD("", on_cmd_cifsr, 0U, ""),
 	};
 
 	/* Wait for acceptable rssi values. */
-	modem_query_rssi();
+	modem_query_rssi(mdata, MDM_AT_CONTROL);
 	k_sleep(MDM_WAIT_FOR_RSSI_DELAY);
 
 	counter = 0;
-	while (counter++ < MDM_WAIT_FOR_RSSI_COUNT && (mdata.rssi >= 0 || mdata.rssi <= -1000)) {
-		modem_query_rssi();
+	while (counter++ < MDM_WAIT_FOR_RSSI_COUNT && (mdata->rssi >= 0 || mdata->rssi <= -1000)) {
+		modem_query_rssi(mdata, MDM_AT_CONTROL);
 		k_sleep(MDM_WAIT_FOR_RSSI_DELAY);
 	}
 
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, cmds, ARRAY_SIZE(cmds), buf,
-			     &mdata.sem_response, MDM_CMD_TIMEOUT);
+	ret = modem_query_registration(mdata, MDM_AT_CONTROL);
 	if (ret < 0) {
-		LOG_ERR("Failed to query registration.");
 		return ret;
 	}
 
-	struct modem_cmd cgatt_cmd[] = {MODEM_CMD("+CGATT: ", on_cmd_cgatt, 1U, "")};
-
 	/* Wait for GPRS Service's status to be attached */
 	counter = 0;
 	while (counter++ < MDM_MAX_CGATT_WAITS &&
-	       (mdata.status_flags & SIM800L_STATUS_FLAG_ATTACHED) == 0) {
-		ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, cgatt_cmd,
-				     ARRAY_SIZE(cgatt_cmd), "AT+CGATT?", &mdata.sem_response,
-				     MDM_CMD_TIMEOUT);
+	       (mdata->status_flags & SIM800L_STATUS_FLAG_ATTACHED) == 0) {
+		ret = modem_query_attach(mdata, MDM_AT_CONTROL);
 		if (ret < 0) {
-			LOG_ERR("Failed to query cgatt.");
 			return ret;
 		}
 		k_sleep(K_SECONDS(1));
 	}
 
-	if ((mdata.status_flags & SIM800L_STATUS_FLAG_CPIN_READY) == 0 ||
-	    (mdata.status_flags & SIM800L_STATUS_FLAG_ATTACHED) == 0) {
+	if ((mdata->status_flags & SIM800L_STATUS_FLAG_CPIN_READY) == 0 ||
+	    (mdata->status_flags & SIM800L_STATUS_FLAG_ATTACHED) == 0) {
 		LOG_ERR("Fatal: Modem is not attached to GPRS network");
 		return -ENETUNREACH;
 	}
 
+	modem_operator_update(mdata);
+
 	/* Enable multi connection */
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, NULL, 0U, "AT+CIPMUX=1",
-			     &mdata.sem_response, K_SECONDS(5));
+	ret = modem_at_send(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+CIPMUX=1", K_SECONDS(5));
 	if (ret < 0) {
 		LOG_ERR("Failed to set multi connection");
 		return ret;
 	}
 
-	/* Get the APN from config */
-	const char *apn = CONFIG_MODEM_SIM800L_APN;
-	/* Set APN if provided */
-	// check if apn is null or empty and if so return error
-	if (!apn || !*apn) {
+	/* Report the sender of received data, UDP needs it for recvfrom() */
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+CIPSRIP=1");
+	if (ret < 0) {
+		LOG_WRN("Failed to enable sender address reporting");
+	}
+
+	if (mdata->apn[0] == '\0') {
 		LOG_WRN("No APN configured");
 		return -EINVAL;
 	}
 
-	char apn_cmd[64];
+	char apn_cmd[MDM_APN_LENGTH + 16];
 
-	snprintk(apn_cmd, sizeof(apn_cmd), "AT+CSTT=\"%s\"", apn);
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, NULL, 0U, apn_cmd,
-			     &mdata.sem_response, MDM_CMD_TIMEOUT);
+	snprintk(apn_cmd, sizeof(apn_cmd), "AT+CSTT=\"%s\"", mdata->apn);
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, apn_cmd);
 	if (ret < 0) {
 		LOG_ERR("Failed to set APN");
 		return ret;
 	}
 
 	/* Bring up wireless connection (GPRS or CSD)*/
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, NULL, 0U, "AT+CIICR",
-			     &mdata.sem_response, MDM_CMD_TIMEOUT);
+	ret = modem_at_send(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+CIICR", MDM_CMD_TIMEOUT);
 	if (ret < 0) {
 		LOG_ERR("Failed to bring up wireless connection");
 		return ret;
 	}
 
 	/* Get local IP address with custom handler */
-	ret = modem_cmd_send(&mdata.ctx.iface, &mdata.ctx.cmd_handler, cifsr_cmd,
-			     ARRAY_SIZE(cifsr_cmd), "AT+CIFSR", &mdata.sem_response,
-			     MDM_CMD_TIMEOUT);
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, cifsr_cmd, ARRAY_SIZE(cifsr_cmd), "AT+CIFSR");
 	if (ret < 0) {
 		LOG_ERR("Failed to get local IP address");
 		return ret;
 	}
 
+	mdata->status_flags |= SIM800L_STATUS_FLAG_PDP_ACTIVE;
+	modem_link_update(mdata);
+
+	return 0;
+}
+
+/*
+ * Deactivate the PDP context. The modem closes every link and answers
+ * SHUT OK instead of OK.
+ */
+int modem_pdp_deactivate(struct sim800l_data *mdata)
+{
+	const struct modem_cmd cmd[] = {MODEM_CMD("SHUT OK", on_cmd_shut_ok, 0U, "")};
+	int ret;
+
+	ret = modem_at_send(mdata, MDM_AT_CONTROL, cmd, ARRAY_SIZE(cmd), "AT+CIPSHUT",
+			    MDM_SHUT_TIMEOUT);
+	if (ret < 0) {
+		LOG_ERR("Failed to deactivate PDP context: %d", ret);
+		return ret;
+	}
+
+	mdata->status_flags &= ~SIM800L_STATUS_FLAG_PDP_ACTIVE;
+	modem_links_reset(mdata);
+	modem_link_update(mdata);
+
+	return 0;
+}
+
+/*
+ * Handler for the bearer query.
+ * +SAPBR: <cid>,<status>,<ip>
+ * status 0 connecting, 1 connected, 2 closing, 3 closed
+ */
+MODEM_CMD_DEFINE(on_cmd_sapbr)
+{
+	struct sim800l_data *mdata = data->user_data;
+
+	mdata->bearer_status = atoi(argv[1]);
+	LOG_DBG("Bearer status: %d", mdata->bearer_status);
+	return 0;
+}
+
+/*
+ * Open bearer profile 1 used by the FTP and HTTP applications. It is
+ * independent of the CSTT/CIICR context carrying the sockets.
+ */
+int modem_bearer_open(struct sim800l_data *mdata)
+{
+	const struct modem_cmd sapbr_cmd[] = {MODEM_CMD("+SAPBR: ", on_cmd_sapbr, 3U, ",")};
+	char apn_cmd[MDM_APN_LENGTH + 24];
+	int ret;
+
+	mdata->bearer_status = -1;
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, sapbr_cmd, ARRAY_SIZE(sapbr_cmd), "AT+SAPBR=2,1");
+	if (ret == 0 && mdata->bearer_status == 1) {
+		return 0;
+	}
+
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+SAPBR=3,1,\"Contype\",\"GPRS\"");
+	if (ret < 0) {
+		LOG_ERR("Failed to set bearer type");
+		return ret;
+	}
+
+	snprintk(apn_cmd, sizeof(apn_cmd), "AT+SAPBR=3,1,\"APN\",\"%s\"", mdata->apn);
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, apn_cmd);
+	if (ret < 0) {
+		LOG_ERR("Failed to set bearer APN");
+		return ret;
+	}
+
+	/* The modem allows up to 85 seconds for the bearer to come up */
+	ret = modem_at_send(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+SAPBR=1,1", MDM_BEARER_TIMEOUT);
+	if (ret < 0) {
+		LOG_ERR("Failed to open bearer");
+		return ret;
+	}
+
 	return 0;
 }
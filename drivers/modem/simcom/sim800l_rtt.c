@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Adaptive response timeouts.
+ *
+ * Every timeout class keeps a smoothed response time and its variance the
+ * way TCP does (RFC 6298): the timeout is srtt + 4 * rttvar, clamped to the
+ * Kconfig floor and ceiling. Until the first answer the ceiling is used,
+ * a missed answer doubles the timeout up to the ceiling again. A modem that
+ * stopped answering is noticed after a few typical response times instead
+ * of the worst case of every command.
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_rtt, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Lower bound of the variance term in ms, the uptime clock granularity */
+#define RTT_GRANULARITY 10
+
+static const struct {
+	uint32_t min;
+	uint32_t max;
+} rtt_limits[MDM_RTT_CLASSES] = {
+	[MDM_RTT_CMD] = {CONFIG_MODEM_SIM800L_TIMEOUT_CMD_MIN,
+			 CONFIG_MODEM_SIM800L_TIMEOUT_CMD_MAX},
+	[MDM_RTT_PROMPT] = {CONFIG_MODEM_SIM800L_TIMEOUT_PROMPT_MIN,
+			    CONFIG_MODEM_SIM800L_TIMEOUT_PROMPT_MAX},
+	[MDM_RTT_SEND] = {CONFIG_MODEM_SIM800L_TIMEOUT_SEND_MIN,
+			  CONFIG_MODEM_SIM800L_TIMEOUT_SEND_MAX},
+	[MDM_RTT_CONNECT] = {CONFIG_MODEM_SIM800L_TIMEOUT_CONNECT_MIN,
+			     CONFIG_MODEM_SIM800L_TIMEOUT_CONNECT_MAX},
+	[MDM_RTT_DNS] = {CONFIG_MODEM_SIM800L_TIMEOUT_DNS_MIN,
+			 CONFIG_MODEM_SIM800L_TIMEOUT_DNS_MAX},
+};
+
+/* CLAMP() in modem_rtt_sample() needs every floor at or below its ceiling */
+BUILD_ASSERT(CONFIG_MODEM_SIM800L_TIMEOUT_CMD_MIN <= CONFIG_MODEM_SIM800L_TIMEOUT_CMD_MAX);
+BUILD_ASSERT(CONFIG_MODEM_SIM800L_TIMEOUT_PROMPT_MIN <= CONFIG_MODEM_SIM800L_TIMEOUT_PROMPT_MAX);
+BUILD_ASSERT(CONFIG_MODEM_SIM800L_TIMEOUT_SEND_MIN <= CONFIG_MODEM_SIM800L_TIMEOUT_SEND_MAX);
+BUILD_ASSERT(CONFIG_MODEM_SIM800L_TIMEOUT_CONNECT_MIN <= CONFIG_MODEM_SIM800L_TIMEOUT_CONNECT_MAX);
+BUILD_ASSERT(CONFIG_MODEM_SIM800L_TIMEOUT_DNS_MIN <= CONFIG_MODEM_SIM800L_TIMEOUT_DNS_MAX);
+
+k_timeout_t modem_rtt_timeout(struct sim800l_data *mdata, enum modem_rtt_class cls)
+{
+	return K_MSEC(mdata->rtt[cls].rto);
+}
+
+/* An answer arrived, start is the uptime in ms the request was sent */
+void modem_rtt_sample(struct sim800l_data *mdata, enum modem_rtt_class cls, int64_t start)
+{
+	struct sim800l_rtt *est = &mdata->rtt[cls];
+	uint32_t r = (uint32_t)MAX(k_uptime_get() - start, 0);
+
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_answer(mdata);
+#endif
+
+	if (!est->measured) {
+		est->srtt = r;
+		est->rttvar = r / 2;
+		est->measured = true;
+	} else {
+		est->rttvar = (3 * est->rttvar + (uint32_t)abs((int32_t)(est->srtt - r))) / 4;
+		est->srtt = (7 * est->srtt + r) / 8;
+	}
+
+	est->rto = CLAMP(est->srtt + MAX(RTT_GRANULARITY, 4 * est->rttvar), rtt_limits[cls].min,
+			 rtt_limits[cls].max);
+}
+
+/* The answer did not arrive in time */
+void modem_rtt_backoff(struct sim800l_data *mdata, enum modem_rtt_class cls)
+{
+	struct sim800l_rtt *est = &mdata->rtt[cls];
+
+	est->rto = MIN(est->rto * 2, rtt_limits[cls].max);
+	LOG_DBG("Timeout class %d backed off to %u ms", cls, est->rto);
+
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_timeout(mdata);
+#endif
+}
+
+void modem_rtt_init(struct sim800l_data *mdata)
+{
+	for (int i = 0; i < MDM_RTT_CLASSES; i++) {
+		mdata->rtt[i].measured = false;
+		mdata->rtt[i].rto = rtt_limits[i].max;
+	}
+}
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Persisted modem identity and network cache.
+ *
+ * The identity strings of the module, the APN and the last serving operator
+ * are kept in the settings subsystem under sim800l/<device>/. A warm boot
+ * only reads the IMEI to check the cached identity still belongs to the
+ * module, and hints the registration with the last operator instead of
+ * starting a full network search.
+ *
+ * The operator is learned in the RX thread, its flash write is deferred to
+ * the control work queue.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_settings, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+#define SETTINGS_ROOT "sim800l"
+
+struct settings_entry {
+	const char *name;
+	size_t offset;
+	size_t size;
+};
+
+#define SETTINGS_ENTRY(_name, _field)                                                              \
+	{                                                                                          \
+		.name = _name,                                                                     \
+		.offset = offsetof(struct sim800l_data, _field),                                   \
+		.size = sizeof(((struct sim800l_data *)0)->_field),                                \
+	}
+
+/* Every value is a string field of the driver data */
+static const struct settings_entry entries[] = {
+	SETTINGS_ENTRY("manufacturer", manufacturer),
+	SETTINGS_ENTRY("model", model),
+	SETTINGS_ENTRY("revision", revision),
+	SETTINGS_ENTRY("imei", imei),
+	SETTINGS_ENTRY("apn", apn),
+	SETTINGS_ENTRY("operator", network.oper),
+	SETTINGS_ENTRY("operator_imsi", network.imsi),
+};
+
+static const struct settings_entry *settings_entry_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (strcmp(entries[i].name, name) == 0) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int settings_load_cb(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+			    void *param)
+{
+	struct sim800l_data *mdata = param;
+	const struct settings_entry *entry;
+	char *dst;
+	ssize_t ret;
+
+	entry = key ? settings_entry_find(key) : NULL;
+	if (!entry || len >= entry->size) {
+		LOG_WRN("Ignoring setting %s", key ? key : "");
+		return 0;
+	}
+
+	dst = (char *)mdata + entry->offset;
+	ret = read_cb(cb_arg, dst, len);
+	dst[MAX(ret, 0)] = '\0';
+
+	return 0;
+}
+
+static void settings_save_value(struct sim800l_data *mdata, const char *name, const char *value)
+{
+	char key[SETTINGS_MAX_NAME_LEN + 1];
+	int ret;
+
+	snprintk(key, sizeof(key), SETTINGS_ROOT "/%s/%s", mdata->dev->name, name);
+
+	ret = settings_save_one(key, value, strlen(value));
+	if (ret < 0) {
+		LOG_WRN("Failed to save %s: %d", key, ret);
+	}
+}
+
+/* Store one cached value, name is the key below the device */
+void modem_settings_save(struct sim800l_data *mdata, const char *name)
+{
+	const struct settings_entry *entry = settings_entry_find(name);
+
+	if (!entry) {
+		return;
+	}
+
+	settings_save_value(mdata, name, (const char *)mdata + entry->offset);
+}
+
+void modem_settings_save_identity(struct sim800l_data *mdata)
+{
+	modem_settings_save(mdata, "manufacturer");
+	modem_settings_save(mdata, "model");
+	modem_settings_save(mdata, "revision");
+	modem_settings_save(mdata, "imei");
+}
+
+/* Store the serving operator, a copy taken under the lock */
+static void settings_network_work(struct k_work *work)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(work, struct sim800l_data, settings.work);
+	char oper[MDM_OPERATOR_LENGTH];
+	char imsi[MDM_IMSI_LENGTH];
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&mdata->settings.lock);
+	strcpy(oper, mdata->settings.oper);
+	strcpy(imsi, mdata->settings.imsi);
+	k_spin_unlock(&mdata->settings.lock, key);
+
+	settings_save_value(mdata, "operator", oper);
+	settings_save_value(mdata, "operator_imsi", imsi);
+}
+
+/*
+ * Queue the serving operator for storage. Called from the RX thread, which
+ * must not wait for a flash write.
+ */
+void modem_settings_save_network(struct sim800l_data *mdata)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&mdata->settings.lock);
+	strcpy(mdata->settings.oper, mdata->network.oper);
+	strcpy(mdata->settings.imsi, mdata->network.imsi);
+	k_spin_unlock(&mdata->settings.lock, key);
+
+	k_work_submit_to_queue(&mdata->ctl_workq, &mdata->settings.work);
+}
+
+/*
+ * Restore the cached values. Called by modem_init() before the modem is
+ * booted, the MAC address derived from the IMEI is then stable from the
+ * first boot on. The storage backend must be initialized before the
+ * driver, see MODEM_SIM800L_INIT_PRIORITY.
+ */
+void modem_settings_load(struct sim800l_data *mdata)
+{
+	char subtree[SETTINGS_MAX_NAME_LEN + 1];
+	int ret;
+
+	k_work_init(&mdata->settings.work, settings_network_work);
+
+	ret = settings_subsys_init();
+	if (ret < 0) {
+		LOG_WRN("Settings unavailable: %d", ret);
+		return;
+	}
+
+	snprintk(subtree, sizeof(subtree), SETTINGS_ROOT "/%s", mdata->dev->name);
+	ret = settings_load_subtree_direct(subtree, settings_load_cb, mdata);
+	if (ret < 0) {
+		LOG_WRN("Failed to load settings: %d", ret);
+	}
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Slow clock sleep controlled by DTR.
+ *
+ * With AT+CSCLK=1 the modem sleeps while DTR is high and the serial port
+ * has been quiet, staying registered and keeping its PDP context. DTR is
+ * raised once the AT channel has been idle for the configured time and
+ * pulled low again when the channel is acquired, 50 ms before the first
+ * command. URCs and received data wake the modem on their own.
+ *
+ * A runtime PM suspend puts the modem to sleep instead of holding it in
+ * reset, so a resume is answered without a new boot and registration.
+ */
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/logging/log.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_sleep, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* Time from DTR low until the modem accepts commands */
+#define SLEEP_WAKE_DELAY K_MSEC(50)
+
+/* Called with the AT channel held */
+static void sleep_enter(struct sim800l_data *mdata)
+{
+	gpio_pin_set_dt(&mdata->dtr_gpio, 1);
+	mdata->sleep.asleep = true;
+	LOG_DBG("Modem asleep");
+}
+
+static void sleep_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct sim800l_data *mdata = CONTAINER_OF(dwork, struct sim800l_data, sleep.work);
+
+	if (!mdata->sleep.enabled || mdata->sleep.asleep) {
+		return;
+	}
+
+	/* Busy again, the next release restarts the idle time */
+	if (modem_at_acquire(mdata, MDM_AT_MONITOR, sys_timepoint_calc(K_NO_WAIT)) < 0) {
+		return;
+	}
+
+	sleep_enter(mdata);
+	modem_at_release(mdata);
+}
+
+/* Called with the AT channel just acquired, before any command is sent */
+void modem_sleep_wake(struct sim800l_data *mdata)
+{
+	if (!mdata->sleep.asleep) {
+		return;
+	}
+
+	gpio_pin_set_dt(&mdata->dtr_gpio, 0);
+	mdata->sleep.asleep = false;
+	k_sleep(SLEEP_WAKE_DELAY);
+	LOG_DBG("Modem awake");
+}
+
+/* Called when the AT channel goes idle */
+void modem_sleep_idle(struct sim800l_data *mdata)
+{
+	if (mdata->sleep.enabled && !mdata->sleep.asleep) {
+		k_work_reschedule(&mdata->sleep.work, K_MSEC(CONFIG_MODEM_SIM800L_SLEEP_IDLE));
+	}
+}
+
+/* Enable sleep after boot, nothing to do without a DTR line */
+int modem_sleep_start(struct sim800l_data *mdata)
+{
+	int ret;
+
+	if (!mdata->dtr_gpio.port) {
+		return 0;
+	}
+
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, NULL, 0U, "AT+CSCLK=1");
+	if (ret < 0) {
+		LOG_WRN("Failed to enable sleep mode: %d", ret);
+		return ret;
+	}
+
+	mdata->sleep.enabled = true;
+	modem_sleep_idle(mdata);
+
+	return 0;
+}
+
+/* The modem is reset or powered off, it wakes up with sleep disabled */
+void modem_sleep_stop(struct sim800l_data *mdata)
+{
+	if (!mdata->dtr_gpio.port) {
+		return;
+	}
+
+	mdata->sleep.enabled = false;
+	k_work_cancel_delayable(&mdata->sleep.work);
+	gpio_pin_set_dt(&mdata->dtr_gpio, 0);
+	mdata->sleep.asleep = false;
+}
+
+/*
+ * Put the modem to sleep for a runtime PM suspend. The background queries
+ * stop so nothing wakes it until the resume. Like sleep_work() it does not
+ * wait for a busy AT channel, -EBUSY lets PM try again later.
+ */
+int modem_sleep_suspend(struct sim800l_data *mdata)
+{
+	bool held = false;
+
+	if (!mdata->sleep.enabled) {
+		return -ENOTSUP;
+	}
+
+	if (!mdata->sleep.asleep) {
+		if (modem_at_acquire(mdata, MDM_AT_CONTROL, sys_timepoint_calc(K_NO_WAIT)) < 0) {
+			return -EBUSY;
+		}
+
+		held = true;
+	}
+
+	modem_monitor_stop(mdata);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_stop(mdata);
+#endif
+	k_work_cancel_delayable(&mdata->sleep.work);
+
+	if (held) {
+		sleep_enter(mdata);
+		modem_at_release(mdata);
+	}
+
+	return 0;
+}
+
+/* Resume from modem_sleep_suspend(), the next command wakes the modem */
+int modem_sleep_resume(struct sim800l_data *mdata)
+{
+	if (!mdata->sleep.enabled) {
+		return -ENOTSUP;
+	}
+
+	modem_monitor_start(mdata);
+#ifdef CONFIG_MODEM_SIM800L_HEALTH
+	modem_health_start(mdata);
+#endif
+	return 0;
+}
+
+int modem_sleep_init(struct sim800l_data *mdata)
+{
+	int ret;
+
+	k_work_init_delayable(&mdata->sleep.work, sleep_work);
+	mdata->sleep.enabled = false;
+	mdata->sleep.asleep = false;
+
+	if (!mdata->dtr_gpio.port) {
+		return 0;
+	}
+
+	if (!gpio_is_ready_dt(&mdata->dtr_gpio)) {
+		LOG_ERR("DTR GPIO device not ready");
+		return -ENODEV;
+	}
+
+	/* Low keeps the modem awake */
+	ret = gpio_pin_configure_dt(&mdata->dtr_gpio, GPIO_OUTPUT_INACTIVE);
+	if (ret < 0) {
+		LOG_ERR("Failed to configure DTR GPIO: %d", ret);
+	}
+
+	return ret;
+}
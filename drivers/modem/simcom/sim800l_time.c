@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Network time.
+ *
+ * With AT+CLTS=1 the modem reports the network time (NITZ) after
+ * registration as *PSUTTZ in UTC and keeps its own RTC in local time. The
+ * RTC read with AT+CCLK? after attach covers networks sending the time
+ * before the URC was enabled, a network report always replaces it. The
+ * time is set on the POSIX realtime clock and on the rtc alias device from
+ * the system work queue.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <zephyr/drivers/rtc.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/timeutil.h>
+
+#ifdef CONFIG_POSIX_TIMERS
+#include <zephyr/posix/time.h>
+#endif
+
+#include <drivers/sim800l.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_time, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+/* The RTC starts at 2004 without a network time, anything earlier is unset */
+#define TIME_MIN_YEAR 2024
+
+#if defined(CONFIG_RTC) && DT_HAS_ALIAS(rtc)
+static const struct device *const time_rtc = DEVICE_DT_GET(DT_ALIAS(rtc));
+#endif
+
+static void time_set_clocks(int64_t utc)
+{
+#ifdef CONFIG_POSIX_TIMERS
+	struct timespec ts = {.tv_sec = utc};
+
+	if (clock_settime(CLOCK_REALTIME, &ts) < 0) {
+		LOG_WRN("Failed to set realtime clock: %d", errno);
+	}
+#endif
+
+#if defined(CONFIG_RTC) && DT_HAS_ALIAS(rtc)
+	struct rtc_time rt = {0};
+	time_t t = utc;
+	struct tm tm;
+	int ret;
+
+	if (!device_is_ready(time_rtc) || !gmtime_r(&t, &tm)) {
+		return;
+	}
+
+	rt.tm_sec = tm.tm_sec;
+	rt.tm_min = tm.tm_min;
+	rt.tm_hour = tm.tm_hour;
+	rt.tm_mday = tm.tm_mday;
+	rt.tm_mon = tm.tm_mon;
+	rt.tm_year = tm.tm_year;
+	rt.tm_wday = tm.tm_wday;
+	rt.tm_yday = tm.tm_yday;
+	rt.tm_isdst = -1;
+
+	ret = rtc_set_time(time_rtc, &rt);
+	if (ret < 0) {
+		LOG_WRN("Failed to set RTC: %d", ret);
+	}
+#endif
+}
+
+static void time_work(struct k_work *work)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(work, struct sim800l_data, time.work);
+	int64_t utc;
+
+	utc = mdata->time.utc + (k_uptime_get() - mdata->time.updated) / MSEC_PER_SEC;
+	time_set_clocks(utc);
+}
+
+/*
+ * Record a received time. The broken down time is shifted by utc_offset
+ * seconds to get UTC, tz is the local time zone in quarter hours.
+ */
+static void time_update(struct sim800l_data *mdata, struct tm *tm, int64_t utc_offset, int tz,
+			enum sim800l_time_source source)
+{
+	if (tm->tm_year + 1900 < TIME_MIN_YEAR || tm->tm_mon < 0 || tm->tm_mon > 11) {
+		LOG_DBG("Ignoring unset modem time");
+		return;
+	}
+
+	/* A network report is not replaced by the RTC it was set from */
+	if (source < mdata->time.source) {
+		return;
+	}
+
+	mdata->time.utc = timeutil_timegm64(tm) + utc_offset;
+	mdata->time.tz = tz;
+	mdata->time.source = source;
+	mdata->time.updated = k_uptime_get();
+
+	LOG_INF("Time %lld UTC from %s", (long long)mdata->time.utc,
+		source == SIM800L_TIME_NETWORK ? "network" : "modem RTC");
+
+	k_work_submit(&mdata->time.work);
+}
+
+/* Parse a time zone like "+32" or "-08" in quarter hours, quotes allowed */
+static int time_zone(const char *s)
+{
+	if (*s == '"') {
+		s++;
+	}
+
+	return (int)strtol(s, NULL, 10);
+}
+
+/*
+ * Network time in UTC, after registration.
+ * *PSUTTZ: <year>,<month>,<day>,<hour>,<min>,<sec>,"<tz>",<dst>
+ */
+void modem_time_network(struct sim800l_data *mdata, char **argv, uint16_t argc)
+{
+	struct tm tm = {0};
+	int year;
+
+	if (argc < 7) {
+		LOG_ERR("Invalid PSUTTZ message format, argc=%d (expected at least 7)", argc);
+		return;
+	}
+
+	/* Two digit years on some firmware */
+	year = atoi(argv[0]);
+	if (year < 100) {
+		year += 2000;
+	}
+
+	tm.tm_year = year - 1900;
+	tm.tm_mon = atoi(argv[1]) - 1;
+	tm.tm_mday = atoi(argv[2]);
+	tm.tm_hour = atoi(argv[3]);
+	tm.tm_min = atoi(argv[4]);
+	tm.tm_sec = atoi(argv[5]);
+
+	time_update(mdata, &tm, 0, time_zone(argv[6]), SIM800L_TIME_NETWORK);
+}
+
+/*
+ * Modem RTC in local time.
+ * +CCLK: "yy/MM/dd,hh:mm:ss+zz"
+ */
+MODEM_CMD_DEFINE(on_cmd_cclk)
+{
+	struct sim800l_data *mdata = data->user_data;
+	const char *p = argv[0];
+	struct tm tm = {0};
+	long fields[6];
+	char *end;
+	int tz;
+
+	if (*p == '"') {
+		p++;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(fields); i++) {
+		fields[i] = strtol(p, &end, 10);
+		if (end == p || *end == '\0') {
+			LOG_WRN("Invalid +CCLK: %s", argv[0]);
+			return 0;
+		}
+
+		p = end + 1;
+	}
+
+	/* The time zone follows the seconds with its sign */
+	tz = time_zone(end);
+
+	tm.tm_year = (int)fields[0] + 2000 - 1900;
+	tm.tm_mon = (int)fields[1] - 1;
+	tm.tm_mday = (int)fields[2];
+	tm.tm_hour = (int)fields[3];
+	tm.tm_min = (int)fields[4];
+	tm.tm_sec = (int)fields[5];
+
+	time_update(mdata, &tm, -tz * 15 * 60, tz, SIM800L_TIME_MODEM_RTC);
+	return 0;
+}
+
+/* Read the modem RTC, unless the network reported the time already */
+void modem_time_query(struct sim800l_data *mdata)
+{
+	const struct modem_cmd cmd[] = {MODEM_CMD("+CCLK: ", on_cmd_cclk, 1U, "")};
+	int ret;
+
+	if (mdata->time.source == SIM800L_TIME_NETWORK) {
+		return;
+	}
+
+	ret = modem_at_cmd(mdata, MDM_AT_CONTROL, cmd, ARRAY_SIZE(cmd), "AT+CCLK?");
+	if (ret < 0) {
+		LOG_WRN("Failed to read modem clock: %d", ret);
+	}
+}
+
+int sim800l_get_time(const struct device *dev, struct sim800l_time_status *status)
+{
+	struct sim800l_data *mdata = dev->data;
+	int64_t age;
+
+	if (!status) {
+		return -EINVAL;
+	}
+
+	status->source = mdata->time.source;
+	if (status->source == SIM800L_TIME_NONE) {
+		return -EAGAIN;
+	}
+
+	age = k_uptime_get() - mdata->time.updated;
+	status->utc = mdata->time.utc + age / MSEC_PER_SEC;
+	status->tz_minutes = mdata->time.tz * 15;
+	status->age_ms = age;
+
+	return 0;
+}
+
+void modem_time_init(struct sim800l_data *mdata)
+{
+	k_work_init(&mdata->time.work, time_work);
+	mdata->time.source = SIM800L_TIME_NONE;
+}
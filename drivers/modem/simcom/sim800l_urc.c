@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem driver
+ *
+ * Deferred URC processing.
+ *
+ * The RX thread only frames the modem output: it matches lines, reads
+ * binary payloads into buffers and completes commands. Everything that
+ * takes socket locks or allocates sockets is queued here in arrival order
+ * and runs on a work queue of its own, so a slow reader or an incoming
+ * connection never holds back OK/ERROR responses or other URCs.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "sim800l.h"
+
+LOG_MODULE_REGISTER(modem_simcom_sim800l_urc, CONFIG_MODEM_SIM800L_LOG_LEVEL);
+
+enum urc_type {
+	URC_DATA,
+	URC_LOST,
+	URC_CLOSED,
+	URC_REMOTE_IP,
+};
+
+static void urc_post(struct sim800l_data *mdata, const struct modem_urc_event *ev)
+{
+	if (k_msgq_put(&mdata->urc.q, ev, K_NO_WAIT) < 0) {
+		LOG_ERR("URC queue full, event %u on link %u dropped", ev->type, ev->link);
+		if (ev->buf) {
+			net_buf_unref(ev->buf);
+		}
+		return;
+	}
+
+	k_work_submit_to_queue(&mdata->urc.workq, &mdata->urc.work);
+}
+
+/* Hand a received payload to its socket and wake the readers */
+static void urc_deliver(struct sim800l_data *mdata, int link, struct net_buf *buf)
+{
+	struct sim800l_socket_data *sock_data;
+	struct modem_socket *sock;
+	size_t len = net_buf_frags_len(buf);
+	size_t buffered;
+
+	sock = modem_socket_from_id(&mdata->socket_config, link);
+	if (!sock) {
+		LOG_WRN("Received data for unknown socket %d", link);
+		net_buf_unref(buf);
+		return;
+	}
+
+	sock_data = sock->data;
+
+	k_mutex_lock(&sock_data->lock, K_FOREVER);
+
+	/* Whatever exceeds SO_RCVBUF is dropped, a datagram as a whole */
+	if (sock->type == SOCK_DGRAM) {
+		if (sock_data->buffered + len > sock_data->rcvbuf) {
+			k_mutex_unlock(&sock_data->lock);
+			LOG_WRN("Socket %d receive buffer full, datagram dropped", link);
+			net_buf_unref(buf);
+			return;
+		}
+
+		sock_data->buffered += len;
+		k_mutex_unlock(&sock_data->lock);
+
+		k_fifo_put(&sock_data->dgram_q, buf);
+		return;
+	}
+
+	/* Nothing follows a close or a hole in the stream */
+	if (sock_data->peer_closed) {
+		k_mutex_unlock(&sock_data->lock);
+		net_buf_unref(buf);
+		return;
+	}
+
+	/* The stream would have a hole, it is reset instead */
+	if (sock_data->buffered + len > sock_data->rcvbuf) {
+		k_mutex_unlock(&sock_data->lock);
+		LOG_ERR("Socket %d receive buffer full", link);
+		net_buf_unref(buf);
+		modem_socket_rx_lost(mdata, link);
+		return;
+	}
+
+	/* Merged into the last buffer when it fits, chained as fragments otherwise */
+	if (!sock_data->rx_buf) {
+		sock_data->rx_buf = buf;
+	} else {
+		struct net_buf *last = net_buf_frag_last(sock_data->rx_buf);
+
+		if (!buf->frags && net_buf_tailroom(last) >= len) {
+			net_buf_add_mem(last, buf->data, len);
+			net_buf_unref(buf);
+		} else {
+			net_buf_frag_add(sock_data->rx_buf, buf);
+		}
+	}
+	sock_data->buffered += len;
+	buffered = sock_data->buffered;
+
+	k_mutex_unlock(&sock_data->lock);
+
+	LOG_DBG("Socket %d buffered %zu bytes", link, buffered);
+	if (len > 0) {
+		/* Signal data is ready */
+		modem_socket_packet_size_update(&mdata->socket_config, sock, buffered);
+		modem_socket_data_ready(&mdata->socket_config, sock);
+	}
+}
+
+static void urc_work(struct k_work *work)
+{
+	struct sim800l_data *mdata = CONTAINER_OF(work, struct sim800l_data, urc.work);
+	struct modem_urc_event ev;
+
+	while (k_msgq_get(&mdata->urc.q, &ev, K_NO_WAIT) == 0) {
+		switch (ev.type) {
+		case URC_DATA:
+			urc_deliver(mdata, ev.link, ev.buf);
+			break;
+		case URC_LOST:
+			modem_socket_rx_lost(mdata, ev.link);
+			break;
+		case URC_CLOSED:
+			modem_socket_peer_closed(mdata, ev.link);
+			break;
+		case URC_REMOTE_IP:
+			modem_server_incoming(mdata, ev.link, ev.ip);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void modem_urc_data(struct sim800l_data *mdata, int link, struct net_buf *buf)
+{
+	struct modem_urc_event ev = {
+		.buf = buf,
+		.type = URC_DATA,
+		.link = link,
+	};
+
+	urc_post(mdata, &ev);
+}
+
+/* Stream data for the link had to be dropped */
+void modem_urc_lost(struct sim800l_data *mdata, int link)
+{
+	struct modem_urc_event ev = {
+		.type = URC_LOST,
+		.link = link,
+	};
+
+	urc_post(mdata, &ev);
+}
+
+void modem_urc_closed(struct sim800l_data *mdata, int link)
+{
+	struct modem_urc_event ev = {
+		.type = URC_CLOSED,
+		.link = link,
+	};
+
+	urc_post(mdata, &ev);
+}
+
+void modem_urc_remote_ip(struct sim800l_data *mdata, int link, const char *ip)
+{
+	struct modem_urc_event ev = {
+		.type = URC_REMOTE_IP,
+		.link = link,
+	};
+
+	strncpy(ev.ip, ip, sizeof(ev.ip) - 1);
+	urc_post(mdata, &ev);
+}
+
+void modem_urc_init(struct sim800l_data *mdata, k_thread_stack_t *stack, size_t stack_size)
+{
+	const struct k_work_queue_config cfg = {
+		.name = "modem_urc",
+	};
+
+	k_msgq_init(&mdata->urc.q, mdata->urc.q_buf, sizeof(struct modem_urc_event),
+		    MDM_URC_QUEUE_LEN);
+	k_work_init(&mdata->urc.work, urc_work);
+	k_work_queue_start(&mdata->urc.workq, stack, stack_size,
+			   K_PRIO_PREEMPT(CONFIG_MODEM_SIM800L_URC_PRIORITY), &cfg);
+}
@@ -0,0 +1,237 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/*
+ * Copyright (c) 2025 Blue Vending
+ * SIM800L modem driver extensions
+ *
+ * Services the modem runs on its own besides the offloaded sockets.
+ */
+
+#ifndef BV_DRIVERS_SIM800L_H_
+#define BV_DRIVERS_SIM800L_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/**
+ * @brief Cached network status
+ */
+struct sim800l_network_status {
+	/** Signal strength in dBm, -1000 when unknown */
+	int rssi;
+	/** Registration status of +CREG, 1 home network, 5 roaming */
+	uint8_t registration;
+	/** Attached to the GPRS service */
+	bool attached;
+	/** Milliseconds since the last refresh, -1 before the modem booted */
+	int64_t age_ms;
+};
+
+/**
+ * @brief Get the network status
+ *
+ * Returns the values kept current by the background monitor without
+ * sending an AT command, so it never waits behind socket traffic.
+ *
+ * @param dev SIM800L modem device
+ * @param status Filled with the cached status
+ * @return 0 on success, negative error code on failure
+ */
+int sim800l_get_network_status(const struct device *dev, struct sim800l_network_status *status);
+
+/**
+ * @brief Source of the modem time
+ */
+enum sim800l_time_source {
+	/** No time received yet */
+	SIM800L_TIME_NONE = 0,
+	/** Modem RTC read with AT+CCLK?, set by an earlier network report */
+	SIM800L_TIME_MODEM_RTC,
+	/** Network time (NITZ) reported after registration */
+	SIM800L_TIME_NETWORK,
+};
+
+/**
+ * @brief Time received from the modem
+ */
+struct sim800l_time_status {
+	enum sim800l_time_source source;
+	/** Seconds since the epoch in UTC, advanced by the uptime since received */
+	int64_t utc;
+	/** Offset of the local time zone in minutes */
+	int tz_minutes;
+	/** Milliseconds since the time was received */
+	int64_t age_ms;
+};
+
+/**
+ * @brief Get the network time
+ *
+ * The time is also set on the POSIX realtime clock and the rtc alias
+ * device when they are enabled.
+ *
+ * @param dev SIM800L modem device
+ * @param status Filled with the time and its source
+ * @return 0 on success, -EAGAIN if no time was received yet
+ */
+int sim800l_get_time(const struct device *dev, struct sim800l_time_status *status);
+
+/**
+ * @brief Set the access point name
+ *
+ * Replaces CONFIG_MODEM_SIM800L_APN from the next PDP context activation
+ * on. With CONFIG_MODEM_SIM800L_SETTINGS the APN is stored and survives a
+ * reboot.
+ *
+ * @param dev SIM800L modem device
+ * @param apn Access point name, empty when the network needs none
+ * @return 0 on success, -EINVAL if the name is too long or contains a quote
+ */
+int sim800l_set_apn(const struct device *dev, const char *apn);
+
+/**
+ * @brief FTP download parameters
+ */
+struct sim800l_ftp_config {
+	/** Server host name or IPv4 address */
+	const char *server;
+	/** Control port, 0 selects 21 */
+	uint16_t port;
+	/** User name, NULL logs in as anonymous */
+	const char *user;
+	/** Password, NULL sends an empty one */
+	const char *password;
+	/** Directory holding the file, with trailing '/', NULL selects "/" */
+	const char *path;
+	/** File to download */
+	const char *filename;
+	/** Byte offset to resume from */
+	size_t offset;
+};
+
+/**
+ * @brief FTP data callback
+ *
+ * Called from the caller's thread for each chunk in file order. The next
+ * chunk is fetched from the modem before the call, so the AT channel is
+ * free and the callback may use other modem functions.
+ *
+ * @param data Chunk data, only valid during the call
+ * @param len Number of bytes in the chunk
+ * @param offset Position of the chunk in the file
+ * @param user_data User data passed to sim800l_ftp_get()
+ * @return 0 to continue, negative error code to abort the download
+ */
+typedef int (*sim800l_ftp_data_cb_t)(const uint8_t *data, size_t len, size_t offset,
+				     void *user_data);
+
+/**
+ * @brief Download a file over FTP
+ *
+ * Blocks until the whole file has been passed to the callback. Only one
+ * download runs per modem at a time.
+ *
+ * @param dev SIM800L modem device
+ * @param cfg Server and file to download
+ * @param cb Callback receiving the file data
+ * @param user_data Passed to the callback
+ * @return 0 on success, negative error code on failure
+ */
+int sim800l_ftp_get(const struct device *dev, const struct sim800l_ftp_config *cfg,
+		    sim800l_ftp_data_cb_t cb, void *user_data);
+
+/**
+ * @brief Download a file over FTP into a flash area
+ *
+ * The area is erased first and written as data arrives. With a non-zero
+ * cfg->offset the download resumes a failed one instead: nothing is erased
+ * and the data is written from that offset into the area. The offset must
+ * be the size reported by the failed attempt.
+ *
+ * @param dev SIM800L modem device
+ * @param cfg Server and file to download
+ * @param area_id Flash area to write, see flash_map
+ * @param size Number of file bytes in the area, including a resumed offset,
+ *             may be NULL
+ * @return 0 on success, -EINVAL for an offset outside the area or not write
+ *         block aligned, other negative error code on failure
+ */
+int sim800l_ftp_get_to_flash(const struct device *dev, const struct sim800l_ftp_config *cfg,
+			     uint8_t area_id, size_t *size);
+
+/**
+ * @brief HTTP request methods, values of AT+HTTPACTION
+ */
+enum sim800l_http_method {
+	SIM800L_HTTP_GET = 0,
+	SIM800L_HTTP_POST = 1,
+	SIM800L_HTTP_HEAD = 2,
+};
+
+/**
+ * @brief HTTP request
+ */
+struct sim800l_http_request {
+	enum sim800l_http_method method;
+	/** Full URL, https:// selects the modem SSL stack */
+	const char *url;
+	/** Content-Type of the body, NULL to omit */
+	const char *content_type;
+	/** Extra header line added to the request, NULL to omit */
+	const char *headers;
+	/** Request body, NULL for none */
+	const void *body;
+	size_t body_len;
+};
+
+/**
+ * @brief Run an HTTP request
+ *
+ * On success the response body stays on the modem until it is read with
+ * sim800l_http_read() and the session is released with
+ * sim800l_http_close(), which must be called from the same thread.
+ *
+ * @param dev SIM800L modem device
+ * @param req Request to send
+ * @param status HTTP status code of the response, may be NULL
+ * @param content_len Length of the response body, may be NULL
+ * @return 0 on success, -EMSGSIZE for a body over 319488 bytes, other
+ *         negative error code on failure
+ */
+int sim800l_http_request(const struct device *dev, const struct sim800l_http_request *req,
+			 int *status, size_t *content_len);
+
+/**
+ * @brief Read the response body
+ *
+ * Continues where the previous read stopped.
+ *
+ * @param dev SIM800L modem device
+ * @param buf Buffer receiving the data
+ * @param len Size of the buffer
+ * @return Number of bytes read, 0 once the body is consumed, -EBADF without
+ *         a session, -EPERM from another thread than the one that started
+ *         it, other negative error code on failure
+ */
+int sim800l_http_read(const struct device *dev, void *buf, size_t len);
+
+/**
+ * @brief End the HTTP session started by sim800l_http_request()
+ *
+ * @param dev SIM800L modem device
+ * @return 0 on success, -EBADF without a session, -EPERM from another
+ *         thread than the one that started it, other negative error code
+ *         on failure
+ */
+int sim800l_http_close(const struct device *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BV_DRIVERS_SIM800L_H_ */
@@ -0,0 +1,381 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem throughput and latency benchmark
+ *
+ * Every result is printed as one JSON object per line prefixed with
+ * "BENCH: " so runs can be collected and compared by scripts.
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(modem_bench, LOG_LEVEL_INF);
+
+#define BENCH_MAX_SOCKETS  5
+#define BENCH_MAX_MSG_SIZE 1024
+#define BENCH_STACK_SIZE   2048
+#define BENCH_MAX_SIZES    8
+
+const struct device *modem = DEVICE_DT_GET(DT_ALIAS(modem));
+
+enum bench_dir {
+	BENCH_UPLOAD,
+	BENCH_DOWNLOAD,
+};
+
+struct bench_worker {
+	struct k_thread thread;
+	enum bench_dir dir;
+	size_t msg_size;
+	size_t bytes;
+	int64_t elapsed_us;
+	int ret;
+	uint8_t buf[BENCH_MAX_MSG_SIZE];
+};
+
+struct bench_stats {
+	int64_t min_us;
+	int64_t max_us;
+	int64_t total_us;
+	int count;
+	int errors;
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, BENCH_MAX_SOCKETS, BENCH_STACK_SIZE);
+static struct bench_worker workers[BENCH_MAX_SOCKETS];
+static K_SEM_DEFINE(start_sem, 0, BENCH_MAX_SOCKETS);
+
+static int64_t bench_now_us(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static void stats_reset(struct bench_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->min_us = INT64_MAX;
+}
+
+static void stats_add(struct bench_stats *stats, int64_t us)
+{
+	stats->min_us = MIN(stats->min_us, us);
+	stats->max_us = MAX(stats->max_us, us);
+	stats->total_us += us;
+	stats->count++;
+}
+
+static void stats_print(const char *test, const struct bench_stats *stats)
+{
+	int64_t avg = stats->count ? stats->total_us / stats->count : 0;
+
+	printk("BENCH: {\"test\":\"%s\",\"samples\":%d,\"errors\":%d,\"min_us\":%lld,"
+	       "\"avg_us\":%lld,\"max_us\":%lld}\n",
+	       test, stats->count, stats->errors, (long long)(stats->count ? stats->min_us : 0),
+	       (long long)avg, (long long)stats->max_us);
+}
+
+static int bench_connect(uint16_t port, int64_t *connect_us)
+{
+	struct sockaddr_in addr = {0};
+	int64_t start;
+	int sock;
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	zsock_inet_pton(AF_INET, CONFIG_BENCH_SERVER_ADDR, &addr.sin_addr);
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	start = bench_now_us();
+	if (zsock_connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		int err = errno;
+
+		zsock_close(sock);
+		return -err;
+	}
+
+	if (connect_us) {
+		*connect_us = bench_now_us() - start;
+	}
+
+	return sock;
+}
+
+static int send_all(int sock, const uint8_t *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t sent = zsock_send(sock, buf, len, 0);
+
+		if (sent < 0) {
+			return -errno;
+		}
+
+		buf += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int recv_exact(int sock, uint8_t *buf, size_t buf_len, size_t len)
+{
+	while (len > 0) {
+		ssize_t got = zsock_recv(sock, buf, MIN(buf_len, len), 0);
+
+		if (got < 0) {
+			return -errno;
+		}
+
+		if (got == 0) {
+			return -ECONNRESET;
+		}
+
+		len -= got;
+	}
+
+	return 0;
+}
+
+/*
+ * Moves CONFIG_BENCH_TRANSFER_SIZE bytes over one socket. Uploads go to the
+ * discard service, downloads are requested from the source service.
+ */
+static void bench_worker_run(void *p1, void *p2, void *p3)
+{
+	struct bench_worker *w = p1;
+	size_t total = CONFIG_BENCH_TRANSFER_SIZE;
+	uint16_t port;
+	int64_t start;
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	port = (w->dir == BENCH_UPLOAD) ? CONFIG_BENCH_DISCARD_PORT : CONFIG_BENCH_SOURCE_PORT;
+
+	sock = bench_connect(port, NULL);
+	if (sock < 0) {
+		w->ret = sock;
+		k_sem_take(&start_sem, K_FOREVER);
+		return;
+	}
+
+	memset(w->buf, 'x', sizeof(w->buf));
+
+	/* All workers start moving data at the same time */
+	k_sem_take(&start_sem, K_FOREVER);
+	start = bench_now_us();
+
+	if (w->dir == BENCH_UPLOAD) {
+		for (size_t done = 0; done < total && w->ret == 0; done += w->msg_size) {
+			w->ret = send_all(sock, w->buf, MIN(w->msg_size, total - done));
+		}
+	} else {
+		int len = snprintk((char *)w->buf, sizeof(w->buf), "%zu", total);
+
+		w->ret = send_all(sock, w->buf, len);
+		if (w->ret == 0) {
+			w->ret = recv_exact(sock, w->buf, w->msg_size, total);
+		}
+	}
+
+	w->elapsed_us = bench_now_us() - start;
+	w->bytes = (w->ret == 0) ? total : 0;
+
+	zsock_close(sock);
+}
+
+static void bench_throughput(enum bench_dir dir, size_t msg_size, int concurrency)
+{
+	int64_t elapsed_us = 0;
+	size_t bytes = 0;
+	int errors = 0;
+
+	for (int i = 0; i < concurrency; i++) {
+		struct bench_worker *w = &workers[i];
+
+		w->dir = dir;
+		w->msg_size = msg_size;
+		w->bytes = 0;
+		w->elapsed_us = 0;
+		w->ret = 0;
+
+		k_thread_create(&w->thread, worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]), bench_worker_run, w, NULL,
+				NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	}
+
+	/* Give the workers time to connect before releasing them together */
+	k_sleep(K_SECONDS(1));
+	for (int i = 0; i < concurrency; i++) {
+		k_sem_give(&start_sem);
+	}
+
+	for (int i = 0; i < concurrency; i++) {
+		k_thread_join(&workers[i].thread, K_FOREVER);
+
+		if (workers[i].ret < 0) {
+			LOG_ERR("Worker %d failed: %d", i, workers[i].ret);
+			errors++;
+		}
+
+		bytes += workers[i].bytes;
+		elapsed_us = MAX(elapsed_us, workers[i].elapsed_us);
+	}
+
+	printk("BENCH: {\"test\":\"%s\",\"sockets\":%d,\"msg_size\":%zu,\"bytes\":%zu,"
+	       "\"errors\":%d,\"time_us\":%lld,\"bps\":%llu}\n",
+	       dir == BENCH_UPLOAD ? "upload" : "download", concurrency, msg_size, bytes, errors,
+	       (long long)elapsed_us,
+	       (unsigned long long)(elapsed_us ? (uint64_t)bytes * 8U * USEC_PER_SEC / elapsed_us
+					       : 0U));
+}
+
+static void bench_request_response(void)
+{
+	uint8_t req[CONFIG_BENCH_LATENCY_MSG_SIZE];
+	uint8_t rsp[CONFIG_BENCH_LATENCY_MSG_SIZE];
+	struct bench_stats stats;
+	int sock;
+
+	stats_reset(&stats);
+	memset(req, 'r', sizeof(req));
+
+	sock = bench_connect(CONFIG_BENCH_ECHO_PORT, NULL);
+	if (sock < 0) {
+		LOG_ERR("Echo connect failed: %d", sock);
+		stats.errors++;
+		stats_print("request_response", &stats);
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_BENCH_LATENCY_ROUNDS; i++) {
+		int64_t start = bench_now_us();
+
+		if (send_all(sock, req, sizeof(req)) < 0 ||
+		    recv_exact(sock, rsp, sizeof(rsp), sizeof(rsp)) < 0) {
+			stats.errors++;
+			continue;
+		}
+
+		stats_add(&stats, bench_now_us() - start);
+	}
+
+	zsock_close(sock);
+	stats_print("request_response", &stats);
+}
+
+static void bench_connect_time(void)
+{
+	struct bench_stats stats;
+
+	stats_reset(&stats);
+
+	for (int i = 0; i < CONFIG_BENCH_CONNECT_ROUNDS; i++) {
+		int64_t us;
+		int sock;
+
+		sock = bench_connect(CONFIG_BENCH_ECHO_PORT, &us);
+		if (sock < 0) {
+			stats.errors++;
+			continue;
+		}
+
+		stats_add(&stats, us);
+		zsock_close(sock);
+	}
+
+	stats_print("connect", &stats);
+}
+
+static void bench_dns_time(void)
+{
+	struct zsock_addrinfo hints = {
+		.ai_family = AF_INET,
+		.ai_socktype = SOCK_STREAM,
+	};
+	struct zsock_addrinfo *res;
+	struct bench_stats stats;
+
+	stats_reset(&stats);
+
+	for (int i = 0; i < CONFIG_BENCH_DNS_ROUNDS; i++) {
+		int64_t start = bench_now_us();
+
+		if (zsock_getaddrinfo(CONFIG_BENCH_SERVER_NAME, NULL, &hints, &res) != 0) {
+			stats.errors++;
+			continue;
+		}
+
+		stats_add(&stats, bench_now_us() - start);
+		zsock_freeaddrinfo(res);
+	}
+
+	stats_print("dns", &stats);
+}
+
+static int parse_msg_sizes(size_t *sizes, int max)
+{
+	const char *p = CONFIG_BENCH_MSG_SIZES;
+	int count = 0;
+
+	while (*p && count < max) {
+		char *end;
+		unsigned long size = strtoul(p, &end, 10);
+
+		if (end == p) {
+			break;
+		}
+
+		if (size > 0 && size <= BENCH_MAX_MSG_SIZE) {
+			sizes[count++] = size;
+		} else {
+			LOG_WRN("Ignoring message size %lu", size);
+		}
+
+		p = (*end == ',') ? end + 1 : end;
+	}
+
+	return count;
+}
+
+int main(void)
+{
+	size_t sizes[BENCH_MAX_SIZES];
+	int size_count;
+
+	LOG_INF("SIM800L Modem Benchmark");
+
+	pm_device_action_run(modem, PM_DEVICE_ACTION_RESUME);
+	if (!device_is_ready(modem)) {
+		LOG_ERR("Modem device not ready!");
+		return -1;
+	}
+
+	size_count = parse_msg_sizes(sizes, ARRAY_SIZE(sizes));
+
+	bench_dns_time();
+	bench_connect_time();
+	bench_request_response();
+
+	for (int s = 0; s < size_count; s++) {
+		for (int c = 1; c <= CONFIG_BENCH_CONCURRENCY; c++) {
+			bench_throughput(BENCH_UPLOAD, sizes[s], c);
+			bench_throughput(BENCH_DOWNLOAD, sizes[s], c);
+		}
+	}
+
+	printk("BENCH: {\"test\":\"done\"}\n");
+
+	return 0;
+}
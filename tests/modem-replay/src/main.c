@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (c) 2025 Blue Vending
+ * Simcom SIM800L modem capture replay
+ *
+ * Feeds a capture printed by "sim800l capture dump" back into the driver
+ * through the UART emulator. Received records are put on the UART paced
+ * by their recorded timestamps, transmitted records are awaited from the
+ * driver and compared, so the driver walks through the captured exchange
+ * again. The result is printed as one JSON object prefixed with "REPLAY: ".
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/util.h>
+
+#include <drivers/sim800l.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(modem_replay, LOG_LEVEL_INF);
+
+#define REPLAY_MAX_RECORDS       1024
+#define REPLAY_MAX_BYTES         32768
+#define REPLAY_LINE_MAX          256
+#define REPLAY_LOOKUP_STACK_SIZE 2048
+
+const struct device *modem = DEVICE_DT_GET(DT_ALIAS(modem));
+const struct device *uart = DEVICE_DT_GET(DT_PARENT(DT_ALIAS(modem)));
+
+/* The capture file selected with REPLAY_CAPTURE at build time */
+static const unsigned char capture_text[] = {
+#include "capture.inc"
+};
+
+enum replay_dir {
+	REPLAY_RX,
+	REPLAY_TX,
+};
+
+struct replay_record {
+	uint32_t time_us;
+	uint8_t dir;
+	uint16_t len;
+	/* Start of the record in replay_bytes */
+	uint16_t offset;
+};
+
+struct replay_stats {
+	int records;
+	size_t rx_bytes;
+	size_t tx_bytes;
+	/* Transmitted records the driver sent differently */
+	int mismatches;
+	/* Transmitted records the driver never sent */
+	int missing;
+	int64_t elapsed_us;
+};
+
+static struct replay_record replay_records[REPLAY_MAX_RECORDS];
+static uint8_t replay_bytes[REPLAY_MAX_BYTES];
+static size_t replay_count;
+static size_t replay_used;
+
+static K_SEM_DEFINE(tx_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(lookup_stack, REPLAY_LOOKUP_STACK_SIZE);
+static struct k_thread lookup_thread;
+static int lookup_ret = -EINPROGRESS;
+static char lookup_addr[NET_IPV4_ADDR_LEN];
+
+static int64_t replay_now_us(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+/*
+ * Parse one capture line: <uptime us> RX|TX <hex>. Lines not starting
+ * with a digit, like the dump header or a shell prompt, are skipped.
+ */
+static int replay_parse(char *line)
+{
+	struct replay_record *rec = &replay_records[replay_count];
+	size_t len = strlen(line);
+	char *p;
+
+	/* Captures saved with CRLF line ends */
+	if (len > 0 && line[len - 1] == '\r') {
+		line[--len] = '\0';
+	}
+
+	if (line[0] < '0' || line[0] > '9') {
+		return 0;
+	}
+
+	if (replay_count == ARRAY_SIZE(replay_records)) {
+		LOG_ERR("More than %d records", REPLAY_MAX_RECORDS);
+		return -ENOMEM;
+	}
+
+	rec->time_us = strtoul(line, &p, 10);
+	if (strncmp(p, " RX ", 4) == 0) {
+		rec->dir = REPLAY_RX;
+	} else if (strncmp(p, " TX ", 4) == 0) {
+		rec->dir = REPLAY_TX;
+	} else {
+		LOG_ERR("Invalid record: %s", line);
+		return -EINVAL;
+	}
+
+	p += 4;
+	rec->offset = replay_used;
+	rec->len = hex2bin(p, strlen(p), &replay_bytes[replay_used],
+			   sizeof(replay_bytes) - replay_used);
+	if (rec->len == 0) {
+		LOG_ERR("Invalid or too much data: %s", line);
+		return -EINVAL;
+	}
+
+	replay_used += rec->len;
+	replay_count++;
+	return 0;
+}
+
+static int replay_load(void)
+{
+	const char *p = (const char *)capture_text;
+	const char *end = p + sizeof(capture_text);
+	char line[REPLAY_LINE_MAX];
+	int ret;
+
+	while (p < end) {
+		const char *eol = memchr(p, '\n', end - p);
+		size_t len = (eol ? eol : end) - p;
+
+		if (len >= sizeof(line)) {
+			LOG_ERR("Capture line longer than %d characters", REPLAY_LINE_MAX - 1);
+			return -EINVAL;
+		}
+
+		memcpy(line, p, len);
+		line[len] = '\0';
+		p += len + 1;
+
+		ret = replay_parse(line);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return replay_count > 0 ? 0 : -ENODATA;
+}
+
+/* Called in the context of the driver writing to the UART */
+static void replay_tx_ready(const struct device *dev, size_t size, void *user_data)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(size);
+	ARG_UNUSED(user_data);
+
+	k_sem_give(&tx_sem);
+}
+
+/* Take len bytes written by the driver, false if it stays silent */
+static bool replay_take_tx(uint8_t *buf, size_t len)
+{
+	size_t got = 0;
+
+	while (true) {
+		got += uart_emul_get_tx_data(uart, buf + got, len - got);
+		if (got == len) {
+			return true;
+		}
+
+		if (k_sem_take(&tx_sem, K_MSEC(CONFIG_REPLAY_TX_TIMEOUT)) < 0) {
+			return false;
+		}
+	}
+}
+
+static void replay_run(struct replay_stats *stats)
+{
+	uint8_t buf[REPLAY_LINE_MAX / 2];
+	uint32_t prev = replay_records[0].time_us;
+	int64_t start = replay_now_us();
+
+	for (size_t i = 0; i < replay_count; i++) {
+		const struct replay_record *rec = &replay_records[i];
+		const uint8_t *data = &replay_bytes[rec->offset];
+		uint64_t delay = (uint32_t)(rec->time_us - prev);
+
+		prev = rec->time_us;
+		stats->records++;
+
+		if (rec->dir == REPLAY_RX) {
+			k_sleep(K_USEC(delay * CONFIG_REPLAY_TIME_SCALE / 100));
+			if (uart_emul_put_rx_data(uart, data, rec->len) < rec->len) {
+				LOG_WRN("UART receive FIFO full at record %zu", i);
+			}
+
+			stats->rx_bytes += rec->len;
+			continue;
+		}
+
+		if (!replay_take_tx(buf, rec->len)) {
+			LOG_WRN("Record %zu not sent: %.*s", i, rec->len, data);
+			stats->missing++;
+			continue;
+		}
+
+		if (memcmp(buf, data, rec->len) != 0) {
+			LOG_WRN("Record %zu sent as %.*s, captured %.*s", i, rec->len, buf,
+				rec->len, data);
+			stats->mismatches++;
+		}
+
+		stats->tx_bytes += rec->len;
+	}
+
+	stats->elapsed_us = replay_now_us() - start;
+}
+
+/* The first lookup brings the modem up, then runs AT+CDNSGIP */
+static void replay_lookup(void *p1, void *p2, void *p3)
+{
+	struct zsock_addrinfo hints = {
+		.ai_family = AF_INET,
+		.ai_socktype = SOCK_STREAM,
+	};
+	struct zsock_addrinfo *res;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	lookup_ret = zsock_getaddrinfo(CONFIG_REPLAY_HOST, NULL, &hints, &res);
+	if (lookup_ret != 0) {
+		return;
+	}
+
+	zsock_inet_ntop(AF_INET, &net_sin(res->ai_addr)->sin_addr, lookup_addr,
+			sizeof(lookup_addr));
+	zsock_freeaddrinfo(res);
+}
+
+int main(void)
+{
+	struct replay_stats stats = {0};
+	struct sim800l_network_status net = {0};
+	struct sim800l_time_status time = {0};
+	int ret;
+
+	LOG_INF("SIM800L Modem Capture Replay");
+
+	if (!device_is_ready(modem) || !device_is_ready(uart)) {
+		LOG_ERR("Modem device not ready!");
+		return -1;
+	}
+
+	ret = replay_load();
+	if (ret < 0) {
+		LOG_ERR("Failed to load capture: %d", ret);
+		return ret;
+	}
+
+	LOG_INF("Replaying %zu records, %zu bytes", replay_count, replay_used);
+
+	uart_emul_callback_tx_data_ready_set(uart, replay_tx_ready, NULL);
+
+	k_thread_create(&lookup_thread, lookup_stack, K_THREAD_STACK_SIZEOF(lookup_stack),
+			replay_lookup, NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+
+	replay_run(&stats);
+
+	if (k_thread_join(&lookup_thread, K_MSEC(CONFIG_REPLAY_TX_TIMEOUT)) < 0) {
+		LOG_WRN("Lookup still running after the capture ended");
+	}
+
+	sim800l_get_network_status(modem, &net);
+	sim800l_get_time(modem, &time);
+
+	printk("REPLAY: {\"records\":%d,\"rx_bytes\":%zu,\"tx_bytes\":%zu,\"mismatches\":%d,"
+	       "\"missing\":%d,\"capture_us\":%u,\"replay_us\":%lld,\"lookup\":%d,"
+	       "\"addr\":\"%s\",\"rssi\":%d,\"registration\":%u,\"attached\":%s,"
+	       "\"time_source\":%d}\n",
+	       stats.records, stats.rx_bytes, stats.tx_bytes, stats.mismatches, stats.missing,
+	       replay_records[replay_count - 1].time_us - replay_records[0].time_us,
+	       (long long)stats.elapsed_us, lookup_ret, lookup_addr, net.rssi, net.registration,
+	       net.attached ? "true" : "false", time.source);
+
+	return 0;
+}